@@ -1,121 +1,224 @@
 ﻿// AStarPathFinder.cpp
 #include "AStarPathFinder.h"
-#include <queue>
-#include <map>
-#include <cmath>
+#include <set>
+#include <tuple>
 #include <limits>
+#include <cmath>
 
-struct CompareF {
-    bool operator()(const std::pair<int, Node>& a, const std::pair<int, Node>& b) {
-        return a.first > b.first;
+const char* tieBreakPolicyName(TieBreakPolicy policy) {
+    switch (policy) {
+    case TieBreakPolicy::HigherG: return "high-g";
+    case TieBreakPolicy::CrossProduct: return "cross-product";
+    case TieBreakPolicy::Fifo: return "fifo";
+    case TieBreakPolicy::Lifo: return "lifo";
+    default: return "none";
     }
-};
+}
 
-std::pair<std::vector<Node>, std::set<Node>> AStarPathFinder::findPath(
+std::pair<std::vector<Node>, CellBitset> AStarPathFinder::findPath(
     const std::vector<std::vector<bool>>& walls,
     const Node& start,
-    const Node& end
+    const Node& end,
+    TieBreakPolicy tieBreak
 ) {
-    std::map<Node, int> gScore;
-    std::map<Node, int> fScore;
-    std::map<Node, Node> cameFrom;
-    std::set<Node> explored;
-
-    std::priority_queue<
-        std::pair<int, Node>,
-        std::vector<std::pair<int, Node>>,
-        CompareF
-    > openSet;
-
-    // Initialize scores
-    for (int y = 0; y < Constants::GRID_HEIGHT; y++) {
-        for (int x = 0; x < Constants::GRID_WIDTH; x++) {
-            Node node{ x, y };
-            gScore[node] = (std::numeric_limits<int>::max)();
-            fScore[node] = (std::numeric_limits<int>::max)();
-        }
+    SearchResult result = search(Grid(walls), start, end, tieBreak);
+    return { std::move(result.path), std::move(result.explored) };
+}
+
+SearchResult AStarPathFinder::search(
+    const Grid& grid,
+    const Node& start,
+    const Node& end,
+    TieBreakPolicy tieBreak,
+    SearchControl* control
+) {
+    // Each policy is its own kernel instantiation; pick one at runtime.
+    switch (tieBreak) {
+    case TieBreakPolicy::HigherG:
+        return BestFirstSearch<AStarTieBreakConfig<HigherGTieBreak>>::run(grid, start, end, {}, {}, control);
+    case TieBreakPolicy::CrossProduct:
+        return BestFirstSearch<AStarTieBreakConfig<CrossProductTieBreak>>::run(grid, start, end, {}, {}, control);
+    case TieBreakPolicy::Fifo:
+        return BestFirstSearch<AStarTieBreakConfig<FifoTieBreak>>::run(grid, start, end, {}, {}, control);
+    case TieBreakPolicy::Lifo:
+        return BestFirstSearch<AStarTieBreakConfig<LifoTieBreak>>::run(grid, start, end, {}, {}, control);
+    default:
+        return BestFirstSearch<AStarSearchConfig>::run(grid, start, end, {}, {}, control);
     }
+}
 
-    gScore[start] = 0;
-    fScore[start] = calculateHeuristic(start, end);
-    openSet.push(std::make_pair(fScore[start], start));
+SearchResult AStarPathFinder::searchNearest(
+    const Grid& grid,
+    const Node& start,
+    const std::vector<Node>& goals,
+    SearchControl* control
+) {
+    NearestGoalHeuristic<OctileHeuristic> heuristic;
+    for (const Node& goal : goals) {
+        if (grid.isWalkable(goal.x, goal.y)) {
+            heuristic.goals.push_back(goal);
+        }
+    }
+    if (heuristic.goals.empty()) {
+        return SearchResult{};
+    }
+    return BestFirstSearch<NearestGoalSearchConfig>::runToAny(
+        grid, start, heuristic.goals, heuristic.goals.front(), heuristic, {}, control);
+}
 
-    while (!openSet.empty()) {
-        Node current = openSet.top().second;
-        openSet.pop();
+// cost <= weight * optimal holds a priori, so optimal >= ceil(cost / weight).
+// Take whichever of that and the search's own lower bound is tighter.
+static void applyWeightBound(SearchResult& result, double weight) {
+    if (result.cost < 0) return;
+    int apriori = static_cast<int>(std::ceil(result.cost / weight - 1e-9));
+    result.lowerBound = (std::max)(result.lowerBound, apriori);
+}
 
-        explored.insert(current);  // Mark node as explored
+SearchResult AStarPathFinder::findPathWeighted(
+    const Grid& grid,
+    const Node& start,
+    const Node& end,
+    double epsilon,
+    SearchControl* control
+) {
+    WeightedHeuristic<OctileHeuristic> heuristic;
+    heuristic.weight = 1.0 + epsilon;
+    SearchResult result = BestFirstSearch<WeightedAStarSearchConfig>::run(grid, start, end, heuristic, {}, control);
+    applyWeightBound(result, heuristic.weight);
+    return result;
+}
 
-        if (current == end) {
-            return { reconstructPath(cameFrom, end), explored };
+// Focal search (A*-epsilon): OPEN is ordered by f, FOCAL holds the open nodes
+// with f <= (1 + epsilon) * fmin ordered by h, and nodes are expanded from FOCAL.
+// The octile heuristic is consistent, so fmin never decreases and FOCAL only
+// has to be topped up from OPEN when fmin rises. The limit is only raised
+// once an expansion is complete: while the expanded node is out of OPEN, the
+// smallest f left there can exceed the fmin its neighbors are about to restore.
+SearchResult AStarPathFinder::findPathFocal(
+    const Grid& grid,
+    const Node& start,
+    const Node& end,
+    double epsilon,
+    SearchControl* control
+) {
+    OctileHeuristic heuristic;
+    const double weight = 1.0 + epsilon;
+    const size_t cellCount = grid.cellCount();
+    SearchResult result;
+
+    // Set entries are counted with a tree node's three links and colour
+    const size_t treeNodeBytes = 4 * sizeof(void*);
+    const size_t scoreBytes = cellCount * (2 * sizeof(int) + sizeof(uint32_t) + 2 * sizeof(uint8_t));
+    const size_t exploredBytes = CellBitset::bytesFor(cellCount);
+    MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    if (!meter.fits(0, scoreBytes, exploredBytes)) {
+        result.status = SearchStatus::MemoryLimit;
+        return result;
+    }
+    meter.update(0, scoreBytes, exploredBytes);
+
+    std::vector<int> gScore(cellCount, (std::numeric_limits<int>::max)());
+    std::vector<int> fScore(cellCount, (std::numeric_limits<int>::max)());
+    std::vector<uint32_t> cameFrom(cellCount, NO_PARENT);
+    std::vector<uint8_t> inOpen(cellCount, 0);
+    std::vector<uint8_t> inFocal(cellCount, 0);
+    std::set<std::pair<int, uint32_t>> openSet;          // (f, index)
+    std::set<std::tuple<int, int, uint32_t>> focalSet;   // (h, f, index)
+    CellBitset explored(grid.width(), grid.height());
+    auto openListBytes = [&] {
+        return openSet.size() * (sizeof(std::pair<int, uint32_t>) + treeNodeBytes)
+            + focalSet.size() * (sizeof(std::tuple<int, int, uint32_t>) + treeNodeBytes);
+    };
+
+    int focalLimit = static_cast<int>(weight * heuristic(start, end));
+    auto addToFocal = [&](uint32_t index) {
+        focalSet.insert({ fScore[index] - gScore[index], fScore[index], index });
+        inFocal[index] = 1;
+    };
+    auto removeFromOpen = [&](uint32_t index) {
+        openSet.erase({ fScore[index], index });
+        if (inFocal[index]) {
+            focalSet.erase({ fScore[index] - gScore[index], fScore[index], index });
+            inFocal[index] = 0;
+        }
+        inOpen[index] = 0;
+    };
+    auto addToOpen = [&](uint32_t index, int g) {
+        if (inOpen[index]) {
+            removeFromOpen(index);
+        }
+        gScore[index] = g;
+        fScore[index] = g + heuristic(grid.node(index), end);
+        openSet.insert({ fScore[index], index });
+        inOpen[index] = 1;
+        if (fScore[index] <= focalLimit) {
+            addToFocal(index);
+        }
+    };
+
+    const uint32_t endIndex = static_cast<uint32_t>(grid.index(end));
+    addToOpen(static_cast<uint32_t>(grid.index(start)), 0);
+
+    while (!focalSet.empty()) {
+        uint32_t current = std::get<2>(*focalSet.begin());
+        int fMin = openSet.begin()->first;
+        removeFromOpen(current);
+
+        Node currentNode = grid.node(current);
+        explored.set(currentNode);
+        result.nodesExpanded++;
+        if (control) {
+            if (control->isCancelled()) {
+                result.status = SearchStatus::Cancelled;
+                break;
+            }
+            control->nodeExpanded(currentNode);
         }
 
-        for (const auto& [neighbor, cost] : getNeighbors(current, walls)) {
-            int tentativeGScore = gScore[current] + cost;
+        if (current == endIndex) {
+            result.status = SearchStatus::Found;
+            result.path = reconstructGridPath(grid, cameFrom, endIndex);
+            // Re-opening re-parents cells after their descendants were scored,
+            // so the parent chain can be cheaper than gScore[endIndex]
+            result.cost = gridPathCost(result.path);
+            result.lowerBound = (std::min)(result.cost, fMin);
+            meter.addPath(result.path.size() * sizeof(Node));
+            break;
+        }
 
+        // Closed nodes are re-opened on improvement so fmin stays a lower bound
+        const int currentG = gScore[current];
+        EightConnected::forEachNeighbor(grid, currentNode.x, currentNode.y, [&](int x, int y, int cost) {
+            uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+            int tentativeGScore = currentG + cost;
             if (tentativeGScore < gScore[neighbor]) {
                 cameFrom[neighbor] = current;
-                gScore[neighbor] = tentativeGScore;
-                fScore[neighbor] = gScore[neighbor] + calculateHeuristic(neighbor, end);
-                openSet.push(std::make_pair(fScore[neighbor], neighbor));
+                addToOpen(neighbor, tentativeGScore);
             }
-        }
-    }
-
-    return { std::vector<Node>(), explored }; // Return empty path and explored nodes if no path found
-}
-
-int AStarPathFinder::calculateHeuristic(const Node& a, const Node& b) {
-    // Octile distance heuristic - accounts for diagonal movement
-    int dx = std::abs(a.x - b.x);
-    int dy = std::abs(a.y - b.y);
-    return 10 * (dx + dy) + (14 - 2 * 10) * std::min(dx, dy);
-}
-
-std::vector<std::pair<Node, int>> AStarPathFinder::getNeighbors(
-    const Node& node,
-    const std::vector<std::vector<bool>>& walls
-) {
-    std::vector<std::pair<Node, int>> neighbors;
-    // Cardinal and diagonal directions
-    const int dx[] = { 1, -1, 0, 0, 1, 1, -1, -1 };
-    const int dy[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
-    const int costs[] = { 10, 10, 10, 10, 14, 14, 14, 14 }; // 10 for cardinal, 14 for diagonal (≈10*√2)
-
-    for (int i = 0; i < 8; i++) {
-        int newX = node.x + dx[i];
-        int newY = node.y + dy[i];
-
-        if (newX >= 0 && newX < Constants::GRID_WIDTH &&
-            newY >= 0 && newY < Constants::GRID_HEIGHT &&
-            !walls[newY][newX]) {
-
-            // For diagonal movements, check if both cardinal neighbors are walkable
-            // to prevent corner cutting
-            if (i >= 4) { // Diagonal movement
-                bool canMoveDiagonally = !walls[node.y][newX] && !walls[newY][node.x];
-                if (!canMoveDiagonally) {
-                    continue;
+        });
+
+        // Top FOCAL up with the nodes that the raised fmin now admits
+        if (!openSet.empty() && static_cast<int>(weight * openSet.begin()->first) > focalLimit) {
+            int oldLimit = focalLimit;
+            focalLimit = static_cast<int>(weight * openSet.begin()->first);
+            for (auto it = openSet.upper_bound({ oldLimit, (std::numeric_limits<uint32_t>::max)() });
+                it != openSet.end() && it->first <= focalLimit; ++it) {
+                if (!inFocal[it->second]) {
+                    addToFocal(it->second);
                 }
             }
-
-            neighbors.push_back({ Node{ newX, newY }, costs[i] });
+        }
+        if (!meter.update(openListBytes(), scoreBytes, exploredBytes)) {
+            result.status = SearchStatus::MemoryLimit;
+            break;
         }
     }
 
-    return neighbors;
-}
-
-std::vector<Node> AStarPathFinder::reconstructPath(
-    const std::map<Node, Node>& cameFrom,
-    Node current
-) {
-    std::vector<Node> path;
-    while (cameFrom.find(current) != cameFrom.end()) {
-        path.push_back(current);
-        current = cameFrom.at(current);
+    if (control) {
+        control->flush();
     }
-    path.push_back(current);  // Add the start node
-    std::reverse(path.begin(), path.end());
-    return path;
+    result.explored = std::move(explored);
+    result.memory = meter.result();
+    applyWeightBound(result, weight);
+    return result;
 }
\ No newline at end of file
@@ -1,28 +1,85 @@
 // AStarPathFinder.h
 #pragma once
-#include "framework.h"
-#include "Constants.h"
-#include "DijkstrasPathFinder.h"  // For Node struct
+#include "Node.h"
+#include "BestFirstSearch.h"
+#include "CellBitset.h"
 #include <vector>
-#include <map>
-#include <set>
+
+struct AStarSearchConfig : DefaultSearchConfig {
+};
+
+template <typename TieBreakPolicyType>
+struct AStarTieBreakConfig : AStarSearchConfig {
+    using TieBreak = TieBreakPolicyType;
+};
+
+// Weighted A*: f = g + (1 + epsilon) * h, re-opening closed nodes so the
+// achieved bound can be reported.
+struct WeightedAStarSearchConfig : AStarSearchConfig {
+    using Heuristic = WeightedHeuristic<OctileHeuristic>;
+    static constexpr bool reopenClosed = true;
+};
+
+// A* towards whichever of several goals is cheapest to reach.
+struct NearestGoalSearchConfig : AStarSearchConfig {
+    using Heuristic = NearestGoalHeuristic<OctileHeuristic>;
+};
+
+// Order in which A* pops entries of equal f.
+enum class TieBreakPolicy {
+    None,
+    HigherG,
+    CrossProduct,
+    Fifo,
+    Lifo
+};
+const int TIE_BREAK_POLICY_COUNT = static_cast<int>(TieBreakPolicy::Lifo) + 1;
+
+const char* tieBreakPolicyName(TieBreakPolicy policy);
 
 class AStarPathFinder {
 public:
-    static std::pair<std::vector<Node>, std::set<Node>> findPath(
+    static std::pair<std::vector<Node>, CellBitset> findPath(
         const std::vector<std::vector<bool>>& walls,
         const Node& start,
-        const Node& end
+        const Node& end,
+        TieBreakPolicy tieBreak = TieBreakPolicy::None
+    );
+
+    // Full result on a prebuilt grid; control (optional) cancels and streams progress.
+    static SearchResult search(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        TieBreakPolicy tieBreak = TieBreakPolicy::None,
+        SearchControl* control = nullptr
     );
 
-private:
-    static int calculateHeuristic(const Node& a, const Node& b);
-    static std::vector<std::pair<Node, int>> getNeighbors(
-        const Node& node,
-        const std::vector<std::vector<bool>>& walls
+    // One search for the cheapest of several goals (e.g. the nearest of many
+    // targets): stops as soon as any goal is expanded. The goal reached is
+    // path.back(); goals that are walls or off the grid are ignored.
+    static SearchResult searchNearest(
+        const Grid& grid,
+        const Node& start,
+        const std::vector<Node>& goals,
+        SearchControl* control = nullptr
     );
-    static std::vector<Node> reconstructPath(
-        const std::map<Node, Node>& cameFrom,
-        Node current
+
+    // Bounded-suboptimal searches: the returned cost is at most (1 + epsilon)
+    // times optimal, and SearchResult::suboptimalityBound() reports the
+    // bound actually proven for this query (often much tighter).
+    static SearchResult findPathWeighted(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        double epsilon,
+        SearchControl* control = nullptr
+    );
+    static SearchResult findPathFocal(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        double epsilon,
+        SearchControl* control = nullptr
     );
-};
\ No newline at end of file
+};
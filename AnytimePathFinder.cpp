@@ -0,0 +1,203 @@
+// AnytimePathFinder.cpp
+#include "AnytimePathFinder.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    const int UNREACHED = (std::numeric_limits<int>::max)();
+}
+
+AnytimePathFinder::AnytimePathFinder(
+    const Grid& grid,
+    const Node& start,
+    const Node& end,
+    double initialEpsilon,
+    double epsilonStep
+) : grid(grid),
+    start(start),
+    end(end),
+    endIndex(static_cast<uint32_t>(grid.index(end))),
+    epsilon((std::max)(1.0, initialEpsilon)),
+    epsilonStep(epsilonStep) {
+}
+
+// Checks the per-cell arrays against the cap before allocating them; if they
+// do not fit, the search finishes without a path.
+void AnytimePathFinder::allocate(size_t memoryLimit) {
+    allocated = true;
+    meter = MemoryMeter(memoryLimit);
+    const size_t cellCount = grid.cellCount();
+    scoreBytes = cellCount * (sizeof(int) + sizeof(uint32_t) + 3 * sizeof(uint8_t));
+    exploredBytes = CellBitset::bytesFor(cellCount);
+    if (!meter.fits(0, scoreBytes, exploredBytes)) {
+        finished = true;
+        return;
+    }
+    meter.update(0, scoreBytes, exploredBytes);
+
+    gScore.assign(cellCount, UNREACHED);
+    cameFrom.assign(cellCount, NO_PARENT);
+    inOpen.assign(cellCount, 0);
+    closed.assign(cellCount, 0);
+    inconsistent.assign(cellCount, 0);
+    explored = CellBitset(grid.width(), grid.height());
+
+    uint32_t startIndex = static_cast<uint32_t>(grid.index(start));
+    gScore[startIndex] = 0;
+    inOpen[startIndex] = 1;
+    openSet.push({ key(startIndex), 0, startIndex });
+}
+
+int AnytimePathFinder::key(uint32_t index) const {
+    return gScore[index] + static_cast<int>(epsilon * heuristic(grid.node(index), end));
+}
+
+const SearchResult& AnytimePathFinder::improve(const SearchBudget& budget, SearchControl* control) {
+    if (!allocated) {
+        allocate(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    }
+    size_t expansions = 0;
+
+    while (!finished) {
+        bool completed = improvePath(budget, control, expansions);
+        if (completed) {
+            completedEpsilon = epsilon;
+        }
+        publishSolution();
+        if (!completed) {
+            break;  // Out of budget or cancelled; the next call resumes from here
+        }
+
+        bool unreachable = gScore[endIndex] == UNREACHED;
+        bool optimal = best.cost >= 0 && best.suboptimalityBound() <= 1.0;
+        if (unreachable || optimal || epsilon <= 1.0) {
+            finished = true;
+            break;
+        }
+        beginNextIteration();
+    }
+
+    if (control) {
+        control->flush();
+    }
+    if (best.cost < 0) {
+        if (meter.exceeded()) {
+            best.status = SearchStatus::MemoryLimit;
+        }
+        else {
+            best.status = control && control->isCancelled() ? SearchStatus::Cancelled : SearchStatus::NoPath;
+        }
+    }
+    best.explored = explored;
+    best.memory = meter.result();
+    return best;
+}
+
+// One ARA* ImprovePath pass at the current epsilon. Returns false if the
+// budget ran out, the query was cancelled or the memory cap was passed before
+// the pass completed; the last also finishes the search.
+bool AnytimePathFinder::improvePath(const SearchBudget& budget, SearchControl* control, size_t& expansions) {
+    while (true) {
+        // Drop entries superseded by a later push or already expanded
+        while (!openSet.empty() &&
+            (!inOpen[openSet.top().index] || openSet.top().priority != key(openSet.top().index))) {
+            openSet.pop();
+        }
+
+        if (openSet.empty()) return true;
+        if (gScore[endIndex] != UNREACHED && gScore[endIndex] <= openSet.top().priority) return true;
+        if (budget.exhausted(expansions)) return false;
+        if (control && control->isCancelled()) return false;
+
+        uint32_t current = openSet.pop().index;
+        inOpen[current] = 0;
+        closed[current] = 1;
+        expansions++;
+        best.nodesExpanded++;
+
+        Node currentNode = grid.node(current);
+        explored.set(currentNode);
+        if (control) {
+            control->nodeExpanded(currentNode);
+        }
+
+        const int currentG = gScore[current];
+        EightConnected::forEachNeighbor(grid, currentNode.x, currentNode.y, [&](int x, int y, int cost) {
+            uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+            int tentativeGScore = currentG + cost;
+            if (tentativeGScore >= gScore[neighbor]) return;
+
+            gScore[neighbor] = tentativeGScore;
+            cameFrom[neighbor] = current;
+            if (!closed[neighbor]) {
+                inOpen[neighbor] = 1;
+                openSet.push({ key(neighbor), 0, neighbor });
+            }
+            else if (!inconsistent[neighbor]) {
+                // Already expanded this pass; repaired in the next one
+                inconsistent[neighbor] = 1;
+                inconsList.push_back(neighbor);
+            }
+        });
+
+        if (!meter.update(openSet.size() * sizeof(OpenEntry) + inconsList.size() * sizeof(uint32_t), scoreBytes, exploredBytes)) {
+            finished = true;
+            return false;
+        }
+    }
+}
+
+// Records the current goal path if it beats the best one so far and refreshes
+// the proven bound.
+void AnytimePathFinder::publishSolution() {
+    if (gScore[endIndex] == UNREACHED) return;
+
+    if (best.cost < 0 || gScore[endIndex] < best.cost) {
+        best.status = SearchStatus::Found;
+        best.path = reconstructGridPath(grid, cameFrom, endIndex);
+        best.cost = gridPathCost(best.path);
+    }
+
+    // cost <= epsilon * optimal holds a priori once a pass has completed
+    int apriori = static_cast<int>(std::ceil(best.cost / completedEpsilon - 1e-9));
+    best.lowerBound = (std::max)({ best.lowerBound, lowerBound(), apriori });
+}
+
+// min over OPEN and INCONS of g + h, capped by the best cost (the ARA* bound).
+// Some state on an optimal path always sits in OPEN or INCONS with optimal g,
+// so this holds mid-pass too.
+int AnytimePathFinder::lowerBound() const {
+    int bound = best.cost;
+    auto consider = [&](uint32_t index) {
+        bound = (std::min)(bound, gScore[index] + heuristic(grid.node(index), end));
+    };
+    openSet.forEach([&](const OpenEntry& entry) {
+        if (inOpen[entry.index]) consider(entry.index);
+    });
+    for (uint32_t index : inconsList) {
+        consider(index);
+    }
+    return bound;
+}
+
+// Lowers epsilon, moves INCONS back into OPEN and rebuilds the heap for the
+// new keys.
+void AnytimePathFinder::beginNextIteration() {
+    epsilon = (std::max)(1.0, epsilon - epsilonStep);
+
+    for (uint32_t index : inconsList) {
+        inconsistent[index] = 0;
+        inOpen[index] = 1;
+    }
+    inconsList.clear();
+
+    BinaryHeapOpenList rebuilt;
+    for (size_t index = 0; index < inOpen.size(); index++) {
+        if (inOpen[index]) {
+            rebuilt.push({ key(static_cast<uint32_t>(index)), 0, static_cast<uint32_t>(index) });
+        }
+    }
+    openSet = std::move(rebuilt);
+    std::fill(closed.begin(), closed.end(), 0);
+}
@@ -0,0 +1,70 @@
+// AnytimePathFinder.h
+#pragma once
+#include "Node.h"
+#include "Grid.h"
+#include "BestFirstSearch.h"
+#include "SearchBudget.h"
+#include "SearchControl.h"
+#include <vector>
+#include <limits>
+
+// Anytime Repairing A* (ARA*). The first call to improve() finds a path with a
+// heavily inflated heuristic, then each further call keeps lowering the
+// inflation and repairing the previous search until the budget runs out or
+// the path is proven optimal. Search state is kept between calls, so a query
+// can be resumed in later frames.
+//
+// The per-cell arrays are allocated by the first call, under that call's
+// memory cap. A cancelled call stops like one out of budget and can be
+// resumed; past the cap the search is finished for good, keeping the best
+// path so far.
+class AnytimePathFinder {
+public:
+    AnytimePathFinder(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        double initialEpsilon = 2.0,
+        double epsilonStep = 0.5
+    );
+
+    // Searches until the budget is exhausted or the path is optimal and
+    // returns the best path found so far (empty if none yet).
+    const SearchResult& improve(const SearchBudget& budget, SearchControl* control = nullptr);
+
+    const SearchResult& bestResult() const { return best; }
+    bool isOptimal() const { return finished && best.suboptimalityBound() <= 1.0; }
+    bool isFinished() const { return finished; }
+
+private:
+    Grid grid;
+    Node start;
+    Node end;
+    uint32_t endIndex;
+    double epsilon;
+    double epsilonStep;
+    double completedEpsilon = (std::numeric_limits<double>::infinity)();
+    bool finished = false;
+    bool allocated = false;
+    OctileHeuristic heuristic;
+    MemoryMeter meter;
+    size_t scoreBytes = 0;
+    size_t exploredBytes = 0;
+
+    std::vector<int> gScore;
+    std::vector<uint32_t> cameFrom;
+    std::vector<uint8_t> inOpen;
+    std::vector<uint8_t> closed;
+    std::vector<uint8_t> inconsistent;
+    std::vector<uint32_t> inconsList;
+    BinaryHeapOpenList openSet;
+    CellBitset explored;
+    SearchResult best;
+
+    void allocate(size_t memoryLimit);
+    int key(uint32_t index) const;
+    bool improvePath(const SearchBudget& budget, SearchControl* control, size_t& expansions);
+    void publishSolution();
+    int lowerBound() const;
+    void beginNextIteration();
+};
@@ -0,0 +1,150 @@
+// AsyncPathfinder.cpp
+#include "AsyncPathfinder.h"
+#include "DijkstrasPathFinder.h"
+#include "GreedyPathFinder.h"
+#include "CompactAStarPathFinder.h"
+#include "JPSPathFinder.h"
+#include "ThetaStarPathFinder.h"
+#include "WavefrontSearch.h"
+#include <algorithm>
+#include <chrono>
+
+AsyncPathfinder::AsyncPathfinder(size_t threadCount) : pool(threadCount) {
+}
+
+QueryHandle AsyncPathfinder::submit(
+    std::shared_ptr<const GridSnapshot> map,
+    const PathQuery& query,
+    SearchControl::ProgressCallback onProgress,
+    CompletionCallback onComplete
+) {
+    uint64_t queryId = nextQueryId++;
+    auto control = std::make_shared<SearchControl>(std::move(onProgress));
+    auto promise = std::make_shared<std::promise<std::shared_ptr<QueryResult>>>();
+    std::shared_future<std::shared_ptr<QueryResult>> future = promise->get_future().share();
+
+    pool.submit([queryId, map, query, control, promise, onComplete = std::move(onComplete)] {
+        auto resultPtr = std::make_shared<QueryResult>();
+        QueryResult& result = *resultPtr;
+        result.query = query;
+        result.map = map;
+        try {
+            if (control->isCancelled()) {
+                result.search.status = SearchStatus::Cancelled;  // Cancelled while queued
+            }
+            else {
+                std::shared_ptr<const Grid> grid = map->grid();  // Flattened by the first query of this version
+                if (query.recordEvents) {
+                    result.events = std::make_shared<SearchEventLog>(grid->width());
+                    control->setEventLog(result.events.get());
+                }
+                auto startTime = std::chrono::high_resolution_clock::now();
+                result.search = runQuery(*grid, query, control.get());
+                auto endTime = std::chrono::high_resolution_clock::now();
+                result.timeMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0;
+            }
+        }
+        catch (...) {
+            // The query still ends: the owner is told, and the handle rethrows
+            if (onComplete) {
+                onComplete(queryId, result);
+            }
+            promise->set_exception(std::current_exception());
+            return;
+        }
+
+        // Callback first: once the future is ready the owner may move the result out
+        if (onComplete) {
+            onComplete(queryId, result);
+        }
+        promise->set_value(std::move(resultPtr));
+    });
+
+    return QueryHandle(queryId, future, control);
+}
+
+bool AsyncPathfinder::isKnownAlgorithm(const std::string& algorithm) {
+    return algorithm == "A*" || algorithm == "Dijkstra" || algorithm == "Greedy" || algorithm == "JPS"
+        || algorithm == "Theta*" || algorithm == "BFS" || algorithm == "Compact A*" || algorithm == "Weighted A*"
+        || algorithm == "Focal" || algorithm == "Anytime A*" || algorithm == "Nearest target";
+}
+
+bool AsyncPathfinder::prunesDeadEnds(const std::string& algorithm) {
+    return algorithm == "A*" || algorithm == "Dijkstra" || algorithm == "Greedy" || algorithm == "Compact A*";
+}
+
+SearchResult AsyncPathfinder::runLowMemoryFallback(const Grid& grid, const PathQuery& query,
+    const SearchResult& failed, SearchControl* control) {
+    // The failed search's memory is freed before the fallback starts, so the
+    // query's peak is the larger of the two
+    SearchResult fallback = CompactAStarPathFinder::search(grid, query.start, query.end, control);
+    fallback.nodesExpanded += failed.nodesExpanded;
+    fallback.memory.peakBytes = (std::max)(fallback.memory.peakBytes, failed.memory.peakBytes);
+    return fallback;
+}
+
+SearchResult AsyncPathfinder::runQuery(const Grid& grid, const PathQuery& query, SearchControl* control) {
+    if (query.deadEnds && prunesDeadEnds(query.algorithm)) {
+        // The copy costs a byte per cell, far less than the search's own per-cell arrays
+        Grid pruned = grid;
+        query.deadEnds->applyTo(pruned, query.start, query.end);
+        PathQuery unpruned = query;
+        unpruned.deadEnds.reset();
+        return runQuery(pruned, unpruned, control);
+    }
+
+    if (query.memoryLimit != 0) {
+        SearchControl ownControl;
+        SearchControl* capped = control ? control : &ownControl;
+        capped->setMemoryLimit(query.memoryLimit);
+        PathQuery uncapped = query;
+        uncapped.memoryLimit = 0;
+        SearchResult result = runQuery(grid, uncapped, capped);
+        if (result.status != SearchStatus::MemoryLimit || !query.lowMemoryFallback
+            || query.algorithm == "Compact A*" || query.algorithm == "Nearest target") {
+            return result;
+        }
+        return runLowMemoryFallback(grid, query, result, capped);
+    }
+
+    if (query.algorithm == "A*") {
+        return AStarPathFinder::search(grid, query.start, query.end, query.tieBreak, control);
+    }
+    if (query.algorithm == "Dijkstra") {
+        return DijkstrasPathFinder::search(grid, query.start, query.end, control);
+    }
+    if (query.algorithm == "Greedy") {
+        return GreedyPathFinder::search(grid, query.start, query.end, control);
+    }
+    if (query.algorithm == "JPS") {
+        return JPSPathFinder::search(grid.toWalls(), query.start, query.end, control);
+    }
+    if (query.algorithm == "Theta*") {
+        return ThetaStarPathFinder::search(grid, query.start, query.end, true, control).search;
+    }
+    if (query.algorithm == "BFS") {
+        return WavefrontSearch::search(grid, query.start, query.end, control);
+    }
+    if (query.algorithm == "Compact A*") {
+        return CompactAStarPathFinder::search(grid, query.start, query.end, control);
+    }
+    if (query.algorithm == "Weighted A*") {
+        return AStarPathFinder::findPathWeighted(grid, query.start, query.end, query.epsilon, control);
+    }
+    if (query.algorithm == "Focal") {
+        return AStarPathFinder::findPathFocal(grid, query.start, query.end, query.epsilon, control);
+    }
+    if (query.algorithm == "Anytime A*") {
+        if (!query.anytime) {
+            AnytimePathFinder finder(grid, query.start, query.end);
+            return finder.improve(SearchBudget::unlimited(), control);
+        }
+        std::lock_guard<std::mutex> lock(query.anytime->mutex);
+        return query.anytime->finder.improve(SearchBudget::forDuration(query.anytime->slice), control);
+    }
+    if (query.algorithm == "Nearest target") {
+        return AStarPathFinder::searchNearest(grid, query.start,
+            query.goals.empty() ? std::vector<Node>{ query.end } : query.goals, control);
+    }
+    return SearchResult{};
+}
@@ -0,0 +1,129 @@
+// AsyncPathfinder.h
+#pragma once
+#include "Node.h"
+#include "Grid.h"
+#include "GridSnapshot.h"
+#include "BestFirstSearch.h"
+#include "SearchControl.h"
+#include "AStarPathFinder.h"
+#include "AnytimePathFinder.h"
+#include "Constants.h"
+#include "WorkerPool.h"
+#include "DeadEndIndex.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// An ARA* search resumed by successive "Anytime A*" queries, each improving it
+// for one time slice. The mutex keeps a query from starting on it while a
+// cancelled one is still running.
+struct AnytimeSearch {
+    AnytimeSearch(const Grid& grid, const Node& start, const Node& end, std::chrono::microseconds slice)
+        : finder(grid, start, end), slice(slice) {
+    }
+
+    AnytimePathFinder finder;
+    std::chrono::microseconds slice;
+    std::mutex mutex;
+};
+
+struct PathQuery {
+    // "A*", "Dijkstra", "JPS", "Greedy", "Theta*" (Lazy Theta*), "BFS" (WavefrontSearch),
+    // "Compact A*", "Weighted A*", "Focal", "Anytime A*" or "Nearest target"
+    std::string algorithm;
+    Node start;
+    Node end;
+    TieBreakPolicy tieBreak = TieBreakPolicy::None;  // A* only
+    bool recordEvents = false;                       // Trace into QueryResult::events
+    // Built for the same map version; A*, Dijkstra, Greedy and Compact A* skip its pruned cells
+    std::shared_ptr<const DeadEndIndex> deadEnds;
+    // Cap on the bytes the search holds (see MemoryMeter), 0 for none. A query
+    // over it ends with SearchStatus::MemoryLimit, or with lowMemoryFallback
+    // is run again by CompactAStarPathFinder within the same cap, which
+    // returns an optimal 8-connected path to end whatever the algorithm
+    // (except Nearest target, which has no single goal)
+    size_t memoryLimit = 0;
+    bool lowMemoryFallback = true;
+    double epsilon = Constants::BOUNDED_SEARCH_EPSILON;  // Weighted A* and Focal
+    std::vector<Node> goals{};                           // Nearest target; just end when empty
+    // Anytime A*: the search to resume, built for the same map version and
+    // endpoints. Without one the query runs a fresh search to the optimal path
+    std::shared_ptr<AnytimeSearch> anytime{};
+};
+
+struct QueryResult {
+    PathQuery query;
+    SearchResult search;
+    double timeMs = 0.0;
+    std::shared_ptr<SearchEventLog> events;  // Set when the query asked for recordEvents
+    std::shared_ptr<const GridSnapshot> map; // Map version the query ran on
+};
+
+// Handle to an in-flight query. Copies share the same query.
+class QueryHandle {
+public:
+    QueryHandle(uint64_t id, std::shared_future<std::shared_ptr<QueryResult>> result, std::shared_ptr<SearchControl> control)
+        : id(id), result(std::move(result)), control(std::move(control)) {
+    }
+
+    uint64_t getId() const { return id; }
+    // Both block until the query has finished, and rethrow what its search
+    // threw (e.g. std::bad_alloc).
+    const QueryResult& getResult() const { return *result.get(); }
+    // Moves the result out instead of copying its path and explored set; for
+    // the one consumer of the query; other copies see the moved-from result.
+    QueryResult takeResult() { return std::move(*result.get()); }
+    bool isReady() const {
+        return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+    void cancel() { control->cancel(); }
+
+private:
+    uint64_t id;
+    std::shared_future<std::shared_ptr<QueryResult>> result;
+    std::shared_ptr<SearchControl> control;
+};
+
+// Runs path queries on a worker pool. Each query reads an immutable map
+// snapshot, so the map can keep changing while it runs; it can be cancelled
+// through its handle, streams expanded nodes through onProgress and reports
+// completion through onComplete (both called on the worker thread, before the
+// handle's future becomes ready) as well as through the handle.
+class AsyncPathfinder {
+public:
+    using CompletionCallback = std::function<void(uint64_t queryId, const QueryResult&)>;
+
+    explicit AsyncPathfinder(size_t threadCount = 0);
+
+    // A query whose search throws still calls onComplete, with no search
+    // result; the handle rethrows the exception.
+    QueryHandle submit(
+        std::shared_ptr<const GridSnapshot> map,
+        const PathQuery& query,
+        SearchControl::ProgressCallback onProgress = {},
+        CompletionCallback onComplete = {}
+    );
+
+    size_t queueDepth() const { return pool.queueDepth(); }
+
+    // Synchronous dispatch by algorithm name; used by the workers.
+    static SearchResult runQuery(const Grid& grid, const PathQuery& query, SearchControl* control = nullptr);
+    // Whether runQuery knows the algorithm name.
+    static bool isKnownAlgorithm(const std::string& algorithm);
+    // Whether the algorithm uses PathQuery::deadEnds.
+    static bool prunesDeadEnds(const std::string& algorithm);
+    // Answers a query whose search ended with SearchStatus::MemoryLimit with
+    // CompactAStarPathFinder under the same control; failed's expansions and
+    // peak count towards the result.
+    static SearchResult runLowMemoryFallback(const Grid& grid, const PathQuery& query,
+        const SearchResult& failed, SearchControl* control);
+
+private:
+    std::atomic<uint64_t> nextQueryId{ 1 };
+    WorkerPool pool;
+};
@@ -0,0 +1,253 @@
+// BestFirstSearch.h
+#pragma once
+#include "Grid.h"
+#include "SearchPolicies.h"
+#include "SearchControl.h"
+#include "SearchMemory.h"
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+enum class SearchStatus {
+    Found,
+    NoPath,
+    Cancelled,
+    MemoryLimit     // Stopped at SearchControl::memoryLimit()
+};
+
+struct SearchResult {
+    SearchStatus status = SearchStatus::NoPath;
+    std::vector<Node> path;
+    CellBitset explored;       // Row-major over the grid's width x height
+    int cost = -1;             // -1 when no path was found
+    int lowerBound = -1;       // Proven lower bound on the optimal cost, -1 if not computed
+    size_t nodesExpanded = 0;
+    MemoryUsage memory;        // Peak bytes of the search's structures
+
+    // Achieved suboptimality factor cost / optimal <= cost / lowerBound.
+    double suboptimalityBound() const {
+        if (cost < 0 || lowerBound < 0) return -1.0;
+        return lowerBound == 0 ? 1.0 : static_cast<double>(cost) / lowerBound;
+    }
+};
+
+inline constexpr uint32_t NO_PARENT = (std::numeric_limits<uint32_t>::max)();
+
+// Walks a parent array (indices into grid, NO_PARENT at the start) back from current.
+inline std::vector<Node> reconstructGridPath(
+    const Grid& grid,
+    const std::vector<uint32_t>& cameFrom,
+    uint32_t current
+) {
+    std::vector<Node> path;
+    while (cameFrom[current] != NO_PARENT) {
+        path.push_back(grid.node(current));
+        current = cameFrom[current];
+    }
+    path.push_back(grid.node(current));  // Add the start node
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// Cost of a cell-by-cell path under the 10/14 movement costs.
+inline int gridPathCost(const std::vector<Node>& path) {
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); i++) {
+        bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+        cost += diagonal ? Constants::DIAGONAL_COST : Constants::STRAIGHT_COST;
+    }
+    return cost;
+}
+
+// Single best-first search kernel shared by A*, Dijkstra and Greedy. Config
+// supplies Movement, Heuristic, TieBreak, OpenList, Recorder and Scoring types
+// (see DefaultSearchConfig); every combination is a separate instantiation.
+template <typename Config>
+class BestFirstSearch {
+public:
+    using Movement = typename Config::Movement;
+    using Heuristic = typename Config::Heuristic;
+    using TieBreak = typename Config::TieBreak;
+    using OpenList = typename Config::OpenList;
+    using Recorder = typename Config::Recorder;
+    using Scoring = typename Config::Scoring;
+
+    static SearchResult run(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        const Heuristic& heuristic = Heuristic{},
+        TieBreak tieBreak = TieBreak{},
+        SearchControl* control = nullptr
+    ) {
+        const uint32_t endIndex = static_cast<uint32_t>(grid.index(end));
+        return search(grid, start, end, [endIndex](uint32_t index) { return index == endIndex; },
+            heuristic, tieBreak, control);
+    }
+
+    // Stops at the first of several goals to be expanded, which is the
+    // cheapest one when the heuristic is consistent towards every goal (see
+    // NearestGoalHeuristic). The reached goal is path.back(); reference is
+    // passed to the heuristic and tie-break as their end point.
+    static SearchResult runToAny(
+        const Grid& grid,
+        const Node& start,
+        const std::vector<Node>& goals,
+        const Node& reference,
+        const Heuristic& heuristic = Heuristic{},
+        TieBreak tieBreak = TieBreak{},
+        SearchControl* control = nullptr
+    ) {
+        std::vector<uint8_t> isGoal(grid.cellCount(), 0);
+        for (const Node& goal : goals) {
+            if (grid.inBounds(goal.x, goal.y)) {
+                isGoal[grid.index(goal)] = 1;
+            }
+        }
+        return search(grid, start, reference, [&isGoal](uint32_t index) { return isGoal[index] != 0; },
+            heuristic, tieBreak, control);
+    }
+
+private:
+    template <typename IsGoal>
+    static SearchResult search(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        IsGoal&& isGoal,
+        const Heuristic& heuristic,
+        TieBreak tieBreak,
+        SearchControl* control
+    ) {
+        const size_t cellCount = grid.cellCount();
+        SearchResult result;
+
+        // gScore and cameFrom, the closed flags and the recorder's set are
+        // sized by the grid, so a query too big for its cap fails here
+        const size_t scoreBytes = cellCount * (sizeof(int) + sizeof(uint32_t));
+        const size_t exploredBytes = CellBitset::bytesFor(cellCount) * (std::is_same_v<Recorder, RecordNothing> ? 1 : 2);
+        MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+        if (!meter.fits(0, scoreBytes, exploredBytes)) {
+            result.status = SearchStatus::MemoryLimit;
+            return result;
+        }
+        meter.update(0, scoreBytes, exploredBytes);
+
+        std::vector<int> gScore(cellCount, (std::numeric_limits<int>::max)());
+        std::vector<uint32_t> cameFrom(cellCount, NO_PARENT);
+        CellBitset closed(cellCount);
+        OpenList openSet;
+        Recorder recorder(grid);
+        SearchEventLog* events = control ? control->eventLog() : nullptr;
+
+        const uint32_t startIndex = static_cast<uint32_t>(grid.index(start));
+
+        int startH = heuristic(start, end);
+        gScore[startIndex] = 0;
+        openSet.push({ Scoring::priority(0, startH), tieBreak(0, startH, start, start, end), startIndex });
+        recorder.generated(start);
+        if (events) events->record(SearchEventType::Push, start);
+
+        while (!openSet.empty()) {
+            OpenEntry top = openSet.pop();
+            if (closed.test(top.index)) continue;  // Stale duplicate
+            closed.set(top.index);
+
+            Node current = grid.node(top.index);
+            if (events) events->record(SearchEventType::Pop, current);
+            recorder.expanded(current);
+            result.nodesExpanded++;
+
+            if (control) {
+                if (control->isCancelled()) {
+                    result.status = SearchStatus::Cancelled;
+                    break;
+                }
+                control->nodeExpanded(current);
+            }
+
+            if (isGoal(top.index)) {
+                result.status = SearchStatus::Found;
+                result.path = reconstructGridPath(grid, cameFrom, top.index);
+                result.cost = gScore[top.index];
+                meter.addPath(result.path.size() * sizeof(Node));
+                if constexpr (Config::reopenClosed) {
+                    result.lowerBound = openLowerBound(grid, openSet, gScore, closed, heuristic, end, result.cost);
+                }
+                break;
+            }
+
+            const int currentG = gScore[top.index];
+            Movement::forEachNeighbor(grid, current.x, current.y, [&](int x, int y, int cost) {
+                uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+                if constexpr (!Config::reopenClosed) {
+                    if (closed.test(neighbor)) return;
+                }
+
+                int tentativeGScore = currentG + cost;
+                if (tentativeGScore < gScore[neighbor]) {
+                    if constexpr (Config::reopenClosed) {
+                        closed.reset(neighbor);
+                    }
+                    Node neighborNode{ x, y };
+                    if (events) {
+                        bool discovered = gScore[neighbor] == (std::numeric_limits<int>::max)();
+                        events->record(discovered ? SearchEventType::Push : SearchEventType::Relax, neighborNode);
+                    }
+                    int h = heuristic(neighborNode, end);
+                    gScore[neighbor] = tentativeGScore;
+                    cameFrom[neighbor] = top.index;
+                    openSet.push({
+                        Scoring::priority(tentativeGScore, h),
+                        tieBreak(tentativeGScore, h, neighborNode, start, end),
+                        neighbor
+                    });
+                    recorder.generated(neighborNode);
+                }
+            });
+
+            if (!meter.update(openSet.size() * sizeof(OpenEntry), scoreBytes, exploredBytes)) {
+                result.status = SearchStatus::MemoryLimit;
+                break;
+            }
+        }
+
+        if (control) {
+            control->flush();
+        }
+        result.explored = std::move(recorder.explored);
+        result.memory = meter.result();
+        return result;
+    }
+
+    static int admissibleEstimate(const Heuristic& heuristic, const Node& a, const Node& b) {
+        if constexpr (requires { heuristic.admissible(a, b); }) {
+            return heuristic.admissible(a, b);
+        }
+        else {
+            return heuristic(a, b);
+        }
+    }
+
+    // min(cost, min over open nodes of g + h) with the uninflated heuristic.
+    // With re-opening some open node lies on an optimal path with optimal g,
+    // so this never exceeds the optimal cost.
+    static int openLowerBound(
+        const Grid& grid,
+        const OpenList& openSet,
+        const std::vector<int>& gScore,
+        const CellBitset& closed,
+        const Heuristic& heuristic,
+        const Node& end,
+        int cost
+    ) {
+        int bound = cost;
+        openSet.forEach([&](const OpenEntry& entry) {
+            if (closed.test(entry.index)) return;
+            int f = gScore[entry.index] + admissibleEstimate(heuristic, grid.node(entry.index), end);
+            bound = (std::min)(bound, f);
+        });
+        return bound;
+    }
+};
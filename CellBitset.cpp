@@ -0,0 +1,51 @@
+// CellBitset.cpp
+#include "CellBitset.h"
+#include <algorithm>
+
+size_t CellBitset::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += std::popcount(word);
+    }
+    return total;
+}
+
+bool CellBitset::empty() const {
+    return std::all_of(words.begin(), words.end(), [](uint64_t word) { return word == 0; });
+}
+
+void CellBitset::clear() {
+    std::fill(words.begin(), words.end(), 0);
+}
+
+CellBitset& CellBitset::operator&=(const CellBitset& other) {
+    for (size_t w = 0; w < words.size(); w++) {
+        words[w] &= w < other.words.size() ? other.words[w] : 0;
+    }
+    return *this;
+}
+
+CellBitset& CellBitset::operator|=(const CellBitset& other) {
+    for (size_t w = 0; w < words.size() && w < other.words.size(); w++) {
+        words[w] |= other.words[w];
+    }
+    return *this;
+}
+
+CellBitset& CellBitset::operator-=(const CellBitset& other) {
+    for (size_t w = 0; w < words.size() && w < other.words.size(); w++) {
+        words[w] &= ~other.words[w];
+    }
+    return *this;
+}
+
+CellBitset& CellBitset::operator^=(const CellBitset& other) {
+    for (size_t w = 0; w < words.size() && w < other.words.size(); w++) {
+        words[w] ^= other.words[w];
+    }
+    return *this;
+}
+
+bool CellBitset::operator==(const CellBitset& other) const {
+    return bitsWide == other.bitsWide && bitsHigh == other.bitsHigh && words == other.words;
+}
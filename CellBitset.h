@@ -0,0 +1,82 @@
+// CellBitset.h
+#pragma once
+#include "Node.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+
+// One bit per grid cell, row-major (bit y * width + x), packed 64 to a word.
+// Replaces std::set<Node> for explored and closed sets: about 1/64 of the
+// memory of the cells it covers, count() is a hardware popcount per word, and
+// comparisons between algorithms (cells A* explored but JPS did not, ...) are
+// word-wide bitwise operations. Binary operations expect equal dimensions.
+//
+// Also usable as a flat bit array over any index space (CellBitset(bits)),
+// e.g. the closed flags of a kernel indexed by Grid::index.
+class CellBitset {
+public:
+    CellBitset() = default;
+    CellBitset(int width, int height)
+        : bitsWide(width), bitsHigh(height), words((static_cast<size_t>(width) * height + 63) / 64, 0) {
+    }
+    explicit CellBitset(size_t bitCount) : CellBitset(static_cast<int>(bitCount), 1) {
+    }
+
+    int width() const { return bitsWide; }
+    int height() const { return bitsHigh; }
+
+    bool test(size_t bit) const { return (words[bit >> 6] >> (bit & 63)) & 1; }
+    void set(size_t bit) { words[bit >> 6] |= uint64_t{ 1 } << (bit & 63); }
+    void reset(size_t bit) { words[bit >> 6] &= ~(uint64_t{ 1 } << (bit & 63)); }
+
+    bool test(const Node& node) const { return test(bitOf(node)); }
+    void set(const Node& node) { set(bitOf(node)); }
+    void reset(const Node& node) { reset(bitOf(node)); }
+    // Sets the bit; true if it was not set before (like std::set::insert().second).
+    bool insert(const Node& node) {
+        size_t bit = bitOf(node);
+        uint64_t mask = uint64_t{ 1 } << (bit & 63);
+        bool added = !(words[bit >> 6] & mask);
+        words[bit >> 6] |= mask;
+        return added;
+    }
+
+    size_t count() const;
+    bool empty() const;
+    void clear();
+    size_t sizeBytes() const { return words.size() * sizeof(uint64_t); }
+    // sizeBytes() of a set over bitCount bits, without building one.
+    static size_t bytesFor(size_t bitCount) { return (bitCount + 63) / 64 * sizeof(uint64_t); }
+
+    // Visits set cells in row-major order, skipping empty words.
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t word = words[w];
+            while (word) {
+                size_t bit = w * 64 + std::countr_zero(word);
+                visit(Node{ static_cast<int>(bit % bitsWide), static_cast<int>(bit / bitsWide) });
+                word &= word - 1;
+            }
+        }
+    }
+
+    CellBitset& operator&=(const CellBitset& other);
+    CellBitset& operator|=(const CellBitset& other);
+    CellBitset& operator-=(const CellBitset& other);  // Set difference
+    CellBitset& operator^=(const CellBitset& other);
+    bool operator==(const CellBitset& other) const;
+
+    friend CellBitset operator&(CellBitset a, const CellBitset& b) { return a &= b; }
+    friend CellBitset operator|(CellBitset a, const CellBitset& b) { return a |= b; }
+    friend CellBitset operator-(CellBitset a, const CellBitset& b) { return a -= b; }
+    friend CellBitset operator^(CellBitset a, const CellBitset& b) { return a ^= b; }
+
+private:
+    int bitsWide = 0;
+    int bitsHigh = 0;
+    std::vector<uint64_t> words;
+
+    size_t bitOf(const Node& node) const { return static_cast<size_t>(node.y) * bitsWide + node.x; }
+};
@@ -0,0 +1,113 @@
+// CompactAStarPathFinder.cpp
+#include "CompactAStarPathFinder.h"
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace {
+    // Step directions, indexed by the 3 bits kept per cell
+    const int STEP_X[] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int STEP_Y[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    const uint8_t CLOSED = 0x8;
+
+    int directionOf(int dx, int dy) {
+        static const int byOffset[3][3] = {
+            { 7, 3, 5 },   // dy = -1: (-1, -1), (0, -1), (1, -1)
+            { 1, -1, 0 },  // dy = 0
+            { 6, 2, 4 }    // dy = 1
+        };
+        return byOffset[dy + 1][dx + 1];
+    }
+}
+
+SearchResult CompactAStarPathFinder::search(
+    const Grid& grid,
+    const Node& start,
+    const Node& end,
+    SearchControl* control
+) {
+    SearchResult result;
+    const size_t stateBytes = (grid.cellCount() + 1) / 2;
+    MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    if (!meter.fits(0, stateBytes, 0)) {
+        result.status = SearchStatus::MemoryLimit;
+        return result;
+    }
+    meter.update(0, stateBytes, 0);
+
+    std::vector<uint8_t> state(stateBytes, 0);
+    auto cellState = [&state](uint32_t cell) {
+        return static_cast<uint8_t>((state[cell >> 1] >> ((cell & 1) * 4)) & 0xF);
+    };
+    auto close = [&state](uint32_t cell, uint8_t direction) {
+        state[cell >> 1] |= static_cast<uint8_t>((CLOSED | direction) << ((cell & 1) * 4));
+    };
+
+    auto later = [](const Entry& a, const Entry& b) {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    };
+    std::priority_queue<Entry, std::vector<Entry>, decltype(later)> openSet(later);
+    OctileHeuristic heuristic;
+    SearchEventLog* events = control ? control->eventLog() : nullptr;
+
+    const uint32_t startIndex = static_cast<uint32_t>(grid.index(start));
+    const uint32_t endIndex = static_cast<uint32_t>(grid.index(end));
+    openSet.push({ heuristic(start, end), 0, startIndex << 3 });
+    if (events) events->record(SearchEventType::Push, start);
+
+    while (!openSet.empty()) {
+        Entry top = openSet.top();
+        openSet.pop();
+        const uint32_t cell = top.packed >> 3;
+        if (cellState(cell) & CLOSED) continue;  // Stale duplicate
+        close(cell, static_cast<uint8_t>(top.packed & 7));
+
+        Node current = grid.node(cell);
+        if (events) events->record(SearchEventType::Pop, current);
+        result.nodesExpanded++;
+
+        if (control) {
+            if (control->isCancelled()) {
+                result.status = SearchStatus::Cancelled;
+                break;
+            }
+            control->nodeExpanded(current);
+        }
+
+        if (cell == endIndex) {
+            for (Node at = current; ; ) {
+                result.path.push_back(at);
+                if (grid.index(at) == startIndex) break;
+                int direction = cellState(static_cast<uint32_t>(grid.index(at))) & 7;
+                at = Node{ at.x - STEP_X[direction], at.y - STEP_Y[direction] };
+            }
+            std::reverse(result.path.begin(), result.path.end());
+            result.status = SearchStatus::Found;
+            result.cost = top.g;
+            meter.addPath(result.path.size() * sizeof(Node));
+            break;
+        }
+
+        EightConnected::forEachNeighbor(grid, current.x, current.y, [&](int x, int y, int cost) {
+            uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+            if (cellState(neighbor) & CLOSED) return;
+
+            Node neighborNode{ x, y };
+            int g = top.g + cost;
+            int direction = directionOf(x - current.x, y - current.y);
+            openSet.push({ g + heuristic(neighborNode, end), g, neighbor << 3 | static_cast<uint32_t>(direction) });
+            if (events) events->record(SearchEventType::Push, neighborNode);
+        });
+
+        if (!meter.update(openSet.size() * sizeof(Entry), stateBytes, 0)) {
+            result.status = SearchStatus::MemoryLimit;
+            break;
+        }
+    }
+
+    if (control) {
+        control->flush();
+    }
+    result.memory = meter.result();
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+// CompactAStarPathFinder.h
+#pragma once
+#include "Node.h"
+#include "Grid.h"
+#include "BestFirstSearch.h"
+#include "SearchControl.h"
+#include <cstdint>
+
+// A* for queries whose memory cap (SearchControl::setMemoryLimit) cannot fit
+// the kernel's per-cell g scores and parent indices. Each cell keeps 4 bits,
+// two to a byte: whether it is closed, and the direction it was entered from,
+// which is enough to walk the path back. That is 1/16 of the kernel's 8 bytes
+// a cell; the rest of the memory is the open list.
+//
+// g travels in the open list entries instead of a per-cell array, so every
+// route to an unclosed cell is pushed and the dearer ones are skipped as
+// stale when they surface. The octile heuristic is consistent, so a cell's
+// first entry to surface carries its optimal g and parent, and paths are
+// optimal as A*'s. Equal f goes to the larger g, which keeps the open list
+// short on open ground. Nothing is recorded as explored.
+class CompactAStarPathFinder {
+public:
+    static SearchResult search(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        SearchControl* control = nullptr
+    );
+
+private:
+    struct Entry {
+        int f;
+        int g;
+        uint32_t packed;  // Cell index << 3 | direction of the step into it (grids up to 2^29 cells)
+    };
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+// CompactPath.cpp
+#include "CompactPath.h"
+
+namespace {
+    const int DIRECTION_DX[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    const int DIRECTION_DY[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+}
+
+int CompactPath::directionOf(int dx, int dy) {
+    for (int direction = 0; direction < 8; direction++) {
+        if (DIRECTION_DX[direction] == dx && DIRECTION_DY[direction] == dy) {
+            return direction;
+        }
+    }
+    return -1;
+}
+
+CompactPath CompactPath::fromCells(const std::vector<Node>& cells) {
+    CompactPath path;
+    for (const Node& cell : cells) {
+        path.push(cell);
+    }
+    return path;
+}
+
+void CompactPath::push(const Node& next) {
+    if (cellCount == 0) {
+        startCell = next;
+        lastCell = next;
+        cellCount = 1;
+        return;
+    }
+
+    int direction = directionOf(next.x - lastCell.x, next.y - lastCell.y);
+    if (direction < 0) {
+        return;  // Not an 8-neighbour; not representable
+    }
+
+    if (!runs.empty() && (runs.back() & 7) == direction && (runs.back() >> 3) + 1 < MAX_RUN) {
+        runs.back() += 1 << 3;
+    }
+    else {
+        runs.push_back(static_cast<uint8_t>(direction));
+    }
+    lastCell = next;
+    cellCount++;
+}
+
+std::vector<Node> CompactPath::toNodes() const {
+    std::vector<Node> nodes;
+    nodes.reserve(cellCount);
+    for (const Node& node : *this) {
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+CompactPath::Iterator::Iterator(const CompactPath* path, size_t position)
+    : path(path), position(position), current(path->startCell) {
+}
+
+CompactPath::Iterator& CompactPath::Iterator::operator++() {
+    if (++position >= path->cellCount) {
+        return *this;
+    }
+    if (stepsLeft == 0) {
+        stepsLeft = (path->runs[run] >> 3) + 1;
+        run++;
+    }
+    uint8_t direction = path->runs[run - 1] & 7;
+    current.x += DIRECTION_DX[direction];
+    current.y += DIRECTION_DY[direction];
+    stepsLeft--;
+    return *this;
+}
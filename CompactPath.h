@@ -0,0 +1,74 @@
+// CompactPath.h
+#pragma once
+#include "Node.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+
+// Cell-by-cell path stored as its start cell plus run-length coded steps: each
+// byte holds a direction (3 bits, 8-connected) and a run length of 1-32. A
+// straight run of any length costs a byte per 32 cells instead of 8 bytes per
+// cell, and the cells are only produced when iterated.
+//
+// Consecutive cells must be 8-neighbours, which holds for every path the
+// finders return (JPS expands its jumps, Theta* is rasterized).
+class CompactPath {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Node*;
+        using reference = const Node&;
+
+        Iterator(const CompactPath* path, size_t position);
+
+        const Node& operator*() const { return current; }
+        const Node* operator->() const { return &current; }
+        Iterator& operator++();
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const Iterator& other) const { return position == other.position; }
+        bool operator!=(const Iterator& other) const { return position != other.position; }
+
+    private:
+        const CompactPath* path;
+        size_t position;   // Cells produced so far
+        size_t run = 0;    // Index into path->runs
+        int stepsLeft = 0; // In the current run
+        Node current{ 0, 0 };
+    };
+
+    CompactPath() = default;
+    static CompactPath fromCells(const std::vector<Node>& cells);
+
+    // Appends the next cell; it must be an 8-neighbour of back().
+    void push(const Node& next);
+
+    size_t size() const { return cellCount; }
+    bool empty() const { return cellCount == 0; }
+    Node front() const { return startCell; }
+    Node back() const { return lastCell; }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, cellCount); }
+    std::vector<Node> toNodes() const;
+
+    // Bytes used by the encoding itself (not counting spare capacity).
+    size_t sizeBytes() const { return sizeof(CompactPath) + runs.size(); }
+
+private:
+    static constexpr int MAX_RUN = 32;
+
+    Node startCell{ 0, 0 };
+    Node lastCell{ 0, 0 };
+    size_t cellCount = 0;
+    std::vector<uint8_t> runs;  // Low 3 bits: direction; high 5 bits: run length - 1
+
+    static int directionOf(int dx, int dy);
+};
@@ -0,0 +1,205 @@
+// ComponentIndex.cpp
+#include "ComponentIndex.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+    // Below this many cells per strip the threads cost more than they save
+    const size_t MIN_CELLS_PER_STRIP = 1 << 16;
+
+    // Batches touching more than 1/64 of the cells rebuild instead: the ring
+    // checks of many new walls cost more than one parallel rebuild
+    const size_t BULK_EDIT_REBUILD_RATIO = 64;
+}
+
+ComponentIndex::ComponentIndex(const Grid& grid, size_t threadCount)
+    : gridWidth(grid.width()),
+    gridHeight(grid.height()),
+    threadCount(threadCount == 0 ? (std::max)(1u, std::thread::hardware_concurrency()) : threadCount),
+    blocked(static_cast<size_t>(grid.width()) * grid.height()) {
+    for (int y = 0; y < gridHeight; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            blocked[index(x, y)] = grid.isWalkable(x, y) ? 0 : 1;
+        }
+    }
+    rebuild();
+}
+
+uint32_t ComponentIndex::find(uint32_t element) {
+    uint32_t root = element;
+    while (parent[root] != root) {
+        root = parent[root];
+    }
+    while (parent[element] != root) {
+        uint32_t next = parent[element];
+        parent[element] = root;
+        element = next;
+    }
+    return root;
+}
+
+// Lower root wins, so within a strip roots never point outside the strip.
+void ComponentIndex::unite(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    if (a < b) {
+        parent[b] = a;
+    }
+    else {
+        parent[a] = b;
+    }
+}
+
+// Only touches union-find entries of cells in rows [firstRow, endRow), so
+// strips can run concurrently.
+void ComponentIndex::unionStrip(int firstRow, int endRow) {
+    for (int y = firstRow; y < endRow; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            if (!isFree(x, y)) continue;
+            uint32_t cell = static_cast<uint32_t>(index(x, y));
+            if (x > 0 && isFree(x - 1, y)) unite(cell, cell - 1);
+            if (y > firstRow && isFree(x, y - 1)) unite(cell, cell - gridWidth);
+        }
+    }
+}
+
+void ComponentIndex::rebuild() {
+    const size_t cellCount = blocked.size();
+    parent.resize(cellCount);
+    cellSet.resize(cellCount);
+    for (uint32_t i = 0; i < cellCount; i++) {
+        parent[i] = i;
+        cellSet[i] = i;
+    }
+
+    size_t strips = (std::min)(threadCount, (std::max)(cellCount / MIN_CELLS_PER_STRIP, size_t{ 1 }));
+    strips = (std::min)(strips, static_cast<size_t>((std::max)(gridHeight, 1)));
+    const int rowsPerStrip = static_cast<int>((gridHeight + strips - 1) / strips);
+
+    if (strips <= 1) {
+        unionStrip(0, gridHeight);
+    }
+    else {
+        std::vector<std::thread> workers;
+        for (size_t s = 0; s < strips; s++) {
+            int firstRow = static_cast<int>(s) * rowsPerStrip;
+            int endRow = (std::min)(gridHeight, firstRow + rowsPerStrip);
+            workers.emplace_back([this, firstRow, endRow] { unionStrip(firstRow, endRow); });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        // Stitch each strip to the one above it
+        for (int seam = rowsPerStrip; seam < gridHeight; seam += rowsPerStrip) {
+            for (int x = 0; x < gridWidth; x++) {
+                if (isFree(x, seam) && isFree(x, seam - 1)) {
+                    unite(static_cast<uint32_t>(index(x, seam)), static_cast<uint32_t>(index(x, seam - 1)));
+                }
+            }
+        }
+    }
+
+    // Flatten so queries are a single lookup until the next edit
+    for (uint32_t i = 0; i < cellCount; i++) {
+        find(i);
+    }
+    stale = false;
+    rebuilds++;
+}
+
+// Whether the free cardinal neighbours of (x, y) are all connected to each
+// other around its 8-cell ring, in which case walling (x, y) splits nothing.
+bool ComponentIndex::ringStaysConnected(int x, int y) const {
+    static constexpr int ringDx[] = { 0, 1, 1, 1, 0, -1, -1, -1 };  // N, NE, E, SE, S, SW, W, NW
+    static constexpr int ringDy[] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+    bool free[8];
+    int freeCount = 0;
+    for (int i = 0; i < 8; i++) {
+        free[i] = isFree(x + ringDx[i], y + ringDy[i]);
+        freeCount += free[i];
+    }
+    if (freeCount == 8) {
+        return true;
+    }
+
+    // Walk the ring from a blocked cell, counting runs of free cells that
+    // contain a cardinal neighbour (even positions)
+    int startAt = 0;
+    while (free[startAt]) startAt++;
+    int runsWithCardinal = 0;
+    bool inRun = false;
+    bool runHasCardinal = false;
+    for (int step = 1; step <= 8; step++) {
+        int i = (startAt + step) % 8;
+        if (free[i]) {
+            inRun = true;
+            runHasCardinal = runHasCardinal || (i % 2 == 0);
+        }
+        else if (inRun) {
+            runsWithCardinal += runHasCardinal;
+            inRun = false;
+            runHasCardinal = false;
+        }
+    }
+    return runsWithCardinal <= 1;
+}
+
+void ComponentIndex::setWall(int x, int y, bool state) {
+    if (x < 0 || x >= gridWidth || y < 0 || y >= gridHeight || blocked[index(x, y)] == (state ? 1 : 0)) {
+        return;
+    }
+
+    blocked[index(x, y)] = state ? 1 : 0;
+    if (stale) {
+        return;  // Rebuilt from scratch on the next query anyway
+    }
+
+    if (state) {
+        if (!ringStaysConnected(x, y)) {
+            stale = true;
+        }
+        return;
+    }
+
+    // Opened cell: give it a fresh element (its old one may still link other
+    // cells) and merge it with its free neighbours
+    uint32_t element = static_cast<uint32_t>(parent.size());
+    parent.push_back(element);
+    cellSet[index(x, y)] = element;
+    static constexpr int dx[] = { 1, -1, 0, 0 };
+    static constexpr int dy[] = { 0, 0, 1, -1 };
+    for (int i = 0; i < 4; i++) {
+        if (isFree(x + dx[i], y + dy[i])) {
+            unite(element, cellSet[index(x + dx[i], y + dy[i])]);
+        }
+    }
+}
+
+void ComponentIndex::setWalls(const std::vector<CellEdit>& edits) {
+    if (edits.size() * BULK_EDIT_REBUILD_RATIO < blocked.size()) {
+        for (const CellEdit& edit : edits) {
+            setWall(edit.x, edit.y, edit.wall);
+        }
+        return;
+    }
+
+    for (const CellEdit& edit : edits) {
+        if (edit.x >= 0 && edit.x < gridWidth && edit.y >= 0 && edit.y < gridHeight) {
+            blocked[index(edit.x, edit.y)] = edit.wall ? 1 : 0;
+        }
+    }
+    stale = true;
+}
+
+bool ComponentIndex::connected(const Node& a, const Node& b) {
+    if (!isFree(a.x, a.y) || !isFree(b.x, b.y)) {
+        return false;
+    }
+    if (stale) {
+        rebuild();
+    }
+    return find(cellSet[index(a.x, a.y)]) == find(cellSet[index(b.x, b.y)]);
+}
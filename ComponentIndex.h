@@ -0,0 +1,57 @@
+// ComponentIndex.h
+#pragma once
+#include "Grid.h"
+#include "Node.h"
+#include "MapEdit.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Connected components of the walkable cells, so a query between different
+// components can be answered "no path" without searching.
+//
+// Components use 4-connectivity, which is exactly the reachability of the
+// default EightConnected movement: a diagonal step needs both cardinal cells
+// free, so it never joins cells that are not already 4-connected.
+//
+// Built with union-find over horizontal strips in parallel, then stitched at
+// the strip seams. Edits are incremental where that is cheap: removing a wall
+// only merges components, and adding one splits nothing as long as the free
+// cells around it stay connected through its 8-cell ring. Otherwise the index
+// is marked stale and rebuilt on the next query.
+class ComponentIndex {
+public:
+    explicit ComponentIndex(const Grid& grid, size_t threadCount = 0);
+
+    void setWall(int x, int y, bool state);
+    // A batch of changed cells. Small batches are applied incrementally; large
+    // ones just mark the index stale, so it is rebuilt once, on the next query.
+    void setWalls(const std::vector<CellEdit>& edits);
+
+    // False if either cell is a wall or outside the grid. Not const: it may
+    // rebuild a stale index and compresses union-find paths.
+    bool connected(const Node& a, const Node& b);
+
+    size_t rebuildCount() const { return rebuilds; }
+
+private:
+    int gridWidth;
+    int gridHeight;
+    size_t threadCount;
+    std::vector<uint8_t> blocked;
+    std::vector<uint32_t> cellSet;  // Union-find element currently standing for each cell
+    std::vector<uint32_t> parent;   // Union-find forest; may outgrow the cell count between rebuilds
+    bool stale = false;
+    size_t rebuilds = 0;
+
+    bool isFree(int x, int y) const {
+        return x >= 0 && x < gridWidth && y >= 0 && y < gridHeight && !blocked[static_cast<size_t>(y) * gridWidth + x];
+    }
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * gridWidth + x; }
+
+    void rebuild();
+    void unionStrip(int firstRow, int endRow);
+    bool ringStaysConnected(int x, int y) const;
+    uint32_t find(uint32_t element);
+    void unite(uint32_t a, uint32_t b);
+};
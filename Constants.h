@@ -7,4 +7,11 @@ namespace Constants {
     const int GRID_HEIGHT = 100;
     const int WINDOW_WIDTH = GRID_WIDTH * CELL_SIZE;
     const int WINDOW_HEIGHT = GRID_HEIGHT * CELL_SIZE;
+    const int STRAIGHT_COST = 10;
+    const int DIAGONAL_COST = 14;  // approximates 10 * sqrt(2)
+    const int ANYTIME_BUDGET_MS = 20;  // Time slice per anytime (ARA*) improvement step
+    const double BOUNDED_SEARCH_EPSILON = 0.05;  // Weighted A* / Focal: cost <= (1 + eps) * optimal
+    const int REPLAY_TICK_MS = 15;
+    const int REPLAY_EVENTS_PER_TICK = 40;
+    const char EVENT_LOG_FILE[] = "search_events.bin";
 }
\ No newline at end of file
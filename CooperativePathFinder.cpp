@@ -0,0 +1,178 @@
+// CooperativePathFinder.cpp
+#include "CooperativePathFinder.h"
+#include "ComponentIndex.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+std::vector<SearchResult> CooperativePathFinder::plan(
+    const Grid& grid,
+    const std::vector<AgentTask>& agents,
+    size_t maxTimeSteps,
+    SearchControl* control
+) {
+    if (maxTimeSteps == 0) {
+        // Room for a long detour plus waiting for every other agent once
+        maxTimeSteps = 4 * static_cast<size_t>(grid.width() + grid.height()) + agents.size();
+    }
+
+    // An agent that cannot be planned stays on its start for good, which the
+    // agents planned before it did not avoid; if one of them passes through
+    // that cell, planning starts over with the agent parked from the start.
+    // Each restart parks one more agent, so there are at most agents + 1 rounds
+    ComponentIndex components(grid, 1);
+    std::vector<bool> parked(agents.size(), false);
+    std::vector<SearchResult> results;
+    for (bool replan = true; replan; ) {
+        replan = false;
+        ReservationTable reservations(grid);
+        for (size_t i = 0; i < agents.size(); i++) {
+            if (parked[i]) {
+                reservations.reservePath({ agents[i].start });
+            }
+        }
+
+        results.assign(agents.size(), SearchResult{});
+        for (size_t i = 0; i < agents.size() && !replan; i++) {
+            const AgentTask& agent = agents[i];
+            if (parked[i]) {
+                continue;  // Reserved above
+            }
+            // A goal in another component would make the space-time search
+            // exhaust every (cell, time) pair up to the horizon
+            if (components.connected(agent.start, agent.goal)) {
+                results[i] = planAgent(grid, agent, reservations, maxTimeSteps, control);
+            }
+
+            SearchStatus status = results[i].status;
+            if (status == SearchStatus::Cancelled || status == SearchStatus::MemoryLimit) {
+                for (size_t j = i + 1; j < agents.size(); j++) {
+                    results[j].status = status;
+                }
+                return results;
+            }
+            if (status == SearchStatus::Found) {
+                reservations.reservePath(results[i].path);
+            }
+            else if (grid.isWalkable(agent.start.x, agent.start.y)) {
+                parked[i] = true;
+                reservations.reservePath({ agent.start });  // Stays put; the others route around it
+                replan = crossedByEarlier(results, i, agent.start);
+            }
+        }
+    }
+    return results;
+}
+
+bool CooperativePathFinder::crossedByEarlier(const std::vector<SearchResult>& results, size_t agent, const Node& cell) {
+    for (size_t i = 0; i < agent; i++) {
+        if (std::find(results[i].path.begin(), results[i].path.end(), cell) != results[i].path.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// States are (cell, time) packed as time * cells + cell. Each action takes
+// one time step, so the time of a state never changes once it is generated
+// and the usual closed-set A* applies.
+SearchResult CooperativePathFinder::planAgent(
+    const Grid& grid,
+    const AgentTask& agent,
+    const ReservationTable& reservations,
+    size_t maxTimeSteps,
+    SearchControl* control
+) {
+    SearchResult result;
+    if (!grid.isWalkable(agent.start.x, agent.start.y) || !grid.isWalkable(agent.goal.x, agent.goal.y)) {
+        return result;
+    }
+
+    // The table is counted as explored state; each state reached holds a
+    // gScore and a cameFrom hash entry
+    const size_t reservedBytes = reservations.sizeBytes();
+    const size_t scoreEntryBytes = sizeof(std::pair<const uint64_t, int>) + sizeof(std::pair<const uint64_t, uint64_t>) + 4 * sizeof(void*);
+    MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    if (!meter.fits(0, 0, reservedBytes)) {
+        result.status = SearchStatus::MemoryLimit;
+        result.memory = meter.result();
+        return result;
+    }
+    meter.update(0, 0, reservedBytes);
+
+    const uint64_t cellCount = grid.cellCount();
+    auto stateKey = [cellCount](size_t cell, uint32_t time) { return static_cast<uint64_t>(time) * cellCount + cell; };
+
+    OctileHeuristic heuristic;
+    using Entry = std::tuple<int, int, uint64_t>;  // f, -g (deeper first on ties), state
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openSet;
+    std::unordered_map<uint64_t, int> gScore;
+    std::unordered_map<uint64_t, uint64_t> cameFrom;
+
+    const uint64_t startKey = stateKey(grid.index(agent.start), 0);
+    gScore[startKey] = 0;
+    openSet.push({ heuristic(agent.start, agent.goal), 0, startKey });
+
+    while (!openSet.empty()) {
+        auto [f, negativeG, key] = openSet.top();
+        openSet.pop();
+        int g = -negativeG;
+        if (g > gScore[key]) continue;  // Stale duplicate
+        result.nodesExpanded++;
+
+        const uint32_t time = static_cast<uint32_t>(key / cellCount);
+        const Node current = grid.node(static_cast<size_t>(key % cellCount));
+        if (control) {
+            if (control->isCancelled()) {
+                result.status = SearchStatus::Cancelled;
+                break;
+            }
+            control->nodeExpanded(current);
+        }
+
+        if (current == agent.goal && reservations.canPark(current, time)) {
+            for (uint64_t at = key; ; at = cameFrom[at]) {
+                result.path.push_back(grid.node(static_cast<size_t>(at % cellCount)));
+                if (at == startKey) break;
+            }
+            std::reverse(result.path.begin(), result.path.end());
+            result.status = SearchStatus::Found;
+            result.cost = g;
+            meter.addPath(result.path.size() * sizeof(Node));
+            break;
+        }
+        if (time >= maxTimeSteps) continue;
+
+        auto tryMove = [&](const Node& next, int cost) {
+            if (reservations.isOccupied(next, time + 1) || reservations.isMoveTaken(next, current, time)) {
+                return;
+            }
+            uint64_t nextKey = stateKey(grid.index(next), time + 1);
+            int tentativeGScore = g + cost;
+            auto known = gScore.find(nextKey);
+            if (known == gScore.end() || tentativeGScore < known->second) {
+                gScore[nextKey] = tentativeGScore;
+                cameFrom[nextKey] = key;
+                openSet.push({ tentativeGScore + heuristic(next, agent.goal), -tentativeGScore, nextKey });
+            }
+        };
+
+        tryMove(current, Constants::STRAIGHT_COST);  // Wait
+        EightConnected::forEachNeighbor(grid, current.x, current.y, [&](int x, int y, int cost) {
+            tryMove(Node{ x, y }, cost);
+        });
+
+        if (!meter.update(openSet.size() * sizeof(Entry), gScore.size() * scoreEntryBytes, reservedBytes)) {
+            result.status = SearchStatus::MemoryLimit;
+            break;
+        }
+    }
+
+    if (control) {
+        control->flush();
+    }
+    result.memory = meter.result();
+    return result;
+}
@@ -0,0 +1,55 @@
+// CooperativePathFinder.h
+#pragma once
+#include "Node.h"
+#include "Grid.h"
+#include "BestFirstSearch.h"
+#include "ReservationTable.h"
+#include <vector>
+
+struct AgentTask {
+    Node start;
+    Node goal;
+};
+
+// Cooperative A*: agents are planned one after another, in the given order,
+// with a space-time A* that avoids everything already in the reservation
+// table; each finished plan is then reserved. Uses the same 8-connected
+// movement and octile heuristic as AStarPathFinder, plus a wait action
+// (costing a straight step). Plans never share a cell at the same time step,
+// never swap cells, and never pass through a cell where an agent has parked.
+//
+// Agents that cannot be planned within maxTimeSteps get SearchStatus::NoPath
+// and stand on their start cell throughout; if an agent planned before one of
+// them passed through that cell, planning starts over with the failed agent
+// parked from the first step, so the plans stay free of conflicts. Order
+// matters, as in any prioritised planner. maxTimeSteps 0 picks a horizon from
+// the grid size.
+//
+// The memory cap applies to each agent's search plus the reservation table,
+// which is what the planner holds at its peak (agents are searched one at a
+// time). A cancelled or capped agent search ends planning: that agent and
+// every agent after it get its status.
+class CooperativePathFinder {
+public:
+    // One result per agent; path[t] is the agent's cell at time step t
+    // (waits repeat the cell) and cost counts waits as straight steps.
+    static std::vector<SearchResult> plan(
+        const Grid& grid,
+        const std::vector<AgentTask>& agents,
+        size_t maxTimeSteps = 0,
+        SearchControl* control = nullptr
+    );
+
+    // Space-time A* for one agent against an existing table.
+    static SearchResult planAgent(
+        const Grid& grid,
+        const AgentTask& agent,
+        const ReservationTable& reservations,
+        size_t maxTimeSteps,
+        SearchControl* control = nullptr
+    );
+
+private:
+    // Whether any of the first agent results' paths visits cell.
+    static bool crossedByEarlier(const std::vector<SearchResult>& results, size_t agent, const Node& cell);
+};
@@ -0,0 +1,329 @@
+// DeadEndIndex.cpp
+#include "DeadEndIndex.h"
+#include "Constants.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace {
+    // Batches touching more than 1/64 of the cells rebuild instead, like
+    // ComponentIndex: one pass over the map beats many overlapping re-erosions
+    const size_t BULK_EDIT_REBUILD_RATIO = 64;
+
+    constexpr int ringDx[] = { 0, 1, 1, 1, 0, -1, -1, -1 };  // N, NE, E, SE, S, SW, W, NW
+    constexpr int ringDy[] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+    using WindowDistances = std::array<std::array<int, 9>, 9>;
+
+    // Distances between the open cells of a 3x3 window (cell (dx, dy) at
+    // index (dy + 1) * 3 + dx + 1) using only moves inside the window. Steps
+    // land on open cells; the corner rule only needs the corners free.
+    WindowDistances windowDistances(const bool free[9], const bool open[9]) {
+        const int unreachable = (std::numeric_limits<int>::max)() / 4;
+        WindowDistances dist;
+        for (int a = 0; a < 9; a++) {
+            dist[a].fill(unreachable);
+            if (open[a]) {
+                dist[a][a] = 0;
+            }
+        }
+        for (int a = 0; a < 9; a++) {
+            for (int b = 0; b < 9; b++) {
+                if (a == b || !open[a] || !open[b]) continue;
+                int ax = a % 3, ay = a / 3, bx = b % 3, by = b / 3;
+                if (std::abs(ax - bx) > 1 || std::abs(ay - by) > 1) continue;
+                if (ax != bx && ay != by) {
+                    if (!free[ay * 3 + bx] || !free[by * 3 + ax]) continue;  // No corner cutting
+                    dist[a][b] = Constants::DIAGONAL_COST;
+                }
+                else {
+                    dist[a][b] = Constants::STRAIGHT_COST;
+                }
+            }
+        }
+        for (int k = 0; k < 9; k++) {
+            for (int a = 0; a < 9; a++) {
+                for (int b = 0; b < 9; b++) {
+                    dist[a][b] = (std::min)(dist[a][b], dist[a][k] + dist[k][b]);
+                }
+            }
+        }
+        return dist;
+    }
+
+    // Indexed by freeMask << 8 | openMask: the ring cells (bit i for
+    // ringDx[i], ringDy[i]) that are not walls, and those of them not pruned.
+    // True if closing the centre leaves every pair of open ring cells as
+    // close as before. Only entries with openMask inside freeMask are used.
+    const std::vector<bool>& redundancyTable() {
+        static const std::vector<bool> table = [] {
+            std::vector<bool> redundant(1 << 16, false);
+            int ring[8];
+            for (int i = 0; i < 8; i++) {
+                ring[i] = (ringDy[i] + 1) * 3 + ringDx[i] + 1;
+            }
+            for (unsigned freeMask = 0; freeMask < 256; freeMask++) {
+                // Every subset of freeMask, down to the empty one
+                for (unsigned openMask = freeMask; ; openMask = (openMask - 1) & freeMask) {
+                    bool free[9] = {};
+                    bool open[9] = {};
+                    for (int i = 0; i < 8; i++) {
+                        free[ring[i]] = (freeMask >> i) & 1;
+                        open[ring[i]] = (openMask >> i) & 1;
+                    }
+                    free[4] = true;
+                    open[4] = true;
+                    WindowDistances with = windowDistances(free, open);
+                    open[4] = false;
+                    WindowDistances without = windowDistances(free, open);
+
+                    bool keepsDistances = true;
+                    for (int i = 0; i < 8 && keepsDistances; i++) {
+                        for (int j = i + 1; j < 8; j++) {
+                            if (open[ring[i]] && open[ring[j]] && without[ring[i]][ring[j]] > with[ring[i]][ring[j]]) {
+                                keepsDistances = false;
+                                break;
+                            }
+                        }
+                    }
+                    redundant[freeMask << 8 | openMask] = keepsDistances;
+                    if (openMask == 0) break;
+                }
+            }
+            return redundant;
+        }();
+        return table;
+    }
+}
+
+DeadEndIndex::DeadEndIndex(const Grid& grid)
+    : gridWidth(grid.width()),
+    gridHeight(grid.height()),
+    blocked(static_cast<size_t>(grid.width()) * grid.height()),
+    pruned(grid.width(), grid.height()),
+    region(blocked.size(), NO_REGION),
+    queued(blocked.size(), 0) {
+    for (int y = 0; y < gridHeight; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            blocked[index(x, y)] = grid.isWalkable(x, y) ? 0 : 1;
+        }
+    }
+    rebuild();
+}
+
+void DeadEndIndex::rebuild() {
+    pruned.clear();
+    members.clear();
+    prunedCells = 0;
+
+    // Reversed so the worklist starts eroding from the top-left corner
+    std::vector<uint32_t> candidates;
+    for (size_t i = blocked.size(); i-- > 0;) {
+        if (!blocked[i]) {
+            candidates.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    erode(std::move(candidates));
+    flatten();
+}
+
+// Prunes what it can, starting from the candidates; every pruned cell puts
+// its open neighbours back on the worklist, since their windows just lost an
+// open cell.
+void DeadEndIndex::erode(std::vector<uint32_t> worklist) {
+    size_t kept = 0;
+    for (uint32_t cell : worklist) {
+        if (!queued[cell]) {
+            queued[cell] = 1;
+            worklist[kept++] = cell;
+        }
+    }
+    worklist.resize(kept);
+
+    while (!worklist.empty()) {
+        uint32_t cell = worklist.back();
+        worklist.pop_back();
+        queued[cell] = 0;
+
+        int x = static_cast<int>(cell % gridWidth);
+        int y = static_cast<int>(cell / gridWidth);
+        if (!isOpen(x, y) || !tryPrune(x, y)) continue;
+
+        for (int i = 0; i < 8; i++) {
+            int nx = x + ringDx[i];
+            int ny = y + ringDy[i];
+            if (!isOpen(nx, ny)) continue;
+            uint32_t neighbor = static_cast<uint32_t>(index(nx, ny));
+            if (!queued[neighbor]) {
+                queued[neighbor] = 1;
+                worklist.push_back(neighbor);
+            }
+        }
+    }
+}
+
+bool DeadEndIndex::tryPrune(int x, int y) {
+    unsigned freeMask = 0;
+    unsigned openMask = 0;
+    for (int i = 0; i < 8; i++) {
+        int nx = x + ringDx[i];
+        int ny = y + ringDy[i];
+        if (!inBounds(nx, ny) || blocked[index(nx, ny)]) continue;
+        freeMask |= 1u << i;
+        if (!pruned.test(index(nx, ny))) {
+            openMask |= 1u << i;
+        }
+    }
+    if (!redundancyTable()[freeMask << 8 | openMask]) {
+        return false;
+    }
+
+    // The regions the cell would join, which must stay under the cap together
+    uint32_t roots[8];
+    int rootCount = 0;
+    size_t joinedSize = 1;
+    for (int i = 0; i < 8; i++) {
+        int nx = x + ringDx[i];
+        int ny = y + ringDy[i];
+        if (!inBounds(nx, ny) || !pruned.test(index(nx, ny))) continue;
+        uint32_t root = find(static_cast<uint32_t>(index(nx, ny)));
+        if (std::find(roots, roots + rootCount, root) == roots + rootCount) {
+            roots[rootCount++] = root;
+            joinedSize += members[root].size();
+        }
+    }
+    if (joinedSize > MAX_REGION_CELLS) {
+        return false;
+    }
+
+    uint32_t cell = static_cast<uint32_t>(index(x, y));
+    pruned.set(cell);
+    region[cell] = cell;
+    members[cell] = { cell };
+    prunedCells++;
+    uint32_t root = cell;
+    for (int i = 0; i < rootCount; i++) {
+        root = unite(root, roots[i]);
+    }
+    return true;
+}
+
+void DeadEndIndex::unpruneRegion(uint32_t root, std::vector<uint32_t>& freed) {
+    auto it = members.find(root);
+    if (it == members.end()) {
+        return;
+    }
+    for (uint32_t cell : it->second) {
+        pruned.reset(cell);
+        freed.push_back(cell);
+    }
+    prunedCells -= it->second.size();
+    members.erase(it);
+}
+
+uint32_t DeadEndIndex::find(uint32_t cell) {
+    uint32_t root = cell;
+    while (region[root] != root) {
+        root = region[root];
+    }
+    while (region[cell] != root) {
+        uint32_t next = region[cell];
+        region[cell] = root;
+        cell = next;
+    }
+    return root;
+}
+
+// Roots only. The larger region absorbs the smaller one's cell list.
+uint32_t DeadEndIndex::unite(uint32_t a, uint32_t b) {
+    if (a == b) return a;
+    if (members[a].size() < members[b].size()) {
+        std::swap(a, b);
+    }
+    std::vector<uint32_t>& absorbed = members[b];
+    members[a].insert(members[a].end(), absorbed.begin(), absorbed.end());
+    members.erase(b);
+    region[b] = a;
+    return a;
+}
+
+// Points every pruned cell straight at its root, so the const lookups of
+// queries need no path compression.
+void DeadEndIndex::flatten() {
+    pruned.forEach([this](const Node& cell) {
+        uint32_t i = static_cast<uint32_t>(index(cell.x, cell.y));
+        region[i] = find(i);
+    });
+}
+
+void DeadEndIndex::setWalls(const std::vector<CellEdit>& edits) {
+    for (const CellEdit& edit : edits) {
+        if (inBounds(edit.x, edit.y)) {
+            blocked[index(edit.x, edit.y)] = edit.wall ? 1 : 0;
+        }
+    }
+    if (edits.size() * BULK_EDIT_REBUILD_RATIO >= blocked.size()) {
+        rebuild();
+        return;
+    }
+
+    // An edit can only invalidate the test of a cell whose window it lies in,
+    // and such a cell's region is within one step of the edit
+    std::vector<uint32_t> candidates;
+    for (const CellEdit& edit : edits) {
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int x = edit.x + dx;
+                int y = edit.y + dy;
+                if (!inBounds(x, y)) continue;
+                uint32_t cell = static_cast<uint32_t>(index(x, y));
+                if (pruned.test(cell)) {
+                    unpruneRegion(find(cell), candidates);
+                }
+                else if (!blocked[cell]) {
+                    candidates.push_back(cell);
+                }
+            }
+        }
+    }
+
+    // Cells bordering a freed region see a different window now as well
+    size_t freedCount = candidates.size();
+    for (size_t c = 0; c < freedCount; c++) {
+        int x = static_cast<int>(candidates[c] % gridWidth);
+        int y = static_cast<int>(candidates[c] / gridWidth);
+        for (int i = 0; i < 8; i++) {
+            if (isOpen(x + ringDx[i], y + ringDy[i])) {
+                candidates.push_back(static_cast<uint32_t>(index(x + ringDx[i], y + ringDy[i])));
+            }
+        }
+    }
+    erode(std::move(candidates));
+    flatten();
+}
+
+bool DeadEndIndex::isPruned(int x, int y) const {
+    return inBounds(x, y) && pruned.test(index(x, y));
+}
+
+uint32_t DeadEndIndex::regionAt(const Node& cell) const {
+    if (!isPruned(cell.x, cell.y)) {
+        return NO_REGION;
+    }
+    return region[index(cell.x, cell.y)];
+}
+
+void DeadEndIndex::applyTo(Grid& grid, const Node& start, const Node& end) const {
+    if (grid.width() != gridWidth || grid.height() != gridHeight) {
+        return;
+    }
+
+    const uint32_t startRegion = regionAt(start);
+    const uint32_t endRegion = regionAt(end);
+    pruned.forEach([&](const Node& cell) {
+        uint32_t root = region[index(cell.x, cell.y)];
+        if (root != startRegion && root != endRegion) {
+            grid.exclude(cell.x, cell.y);
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+// DeadEndIndex.h
+#pragma once
+#include "Grid.h"
+#include "Node.h"
+#include "MapEdit.h"
+#include "CellBitset.h"
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+// Dead ends and swamps: free cells that no optimal path between two other
+// cells needs, so A*, Dijkstra and Greedy can skip them unless the start or
+// goal lies among them.
+//
+// Cells are pruned one at a time by a local test: a cell is redundant if,
+// within its 3x3 window, every pair of its open neighbours is at most as far
+// apart when the cell cannot be stepped onto as when it can. A pruned cell
+// still counts as free for the corner-cutting rule (it is excluded, not
+// walled), so diagonal steps past it stay legal. Each such removal keeps the
+// distances between all the remaining cells, so eroding repeatedly eats cul-de-sacs back to their
+// junctions and rooms with a single door down to the door, while every
+// cell some shortest path needs stays.
+//
+// Pruned cells are grouped into regions (8-connected, at most
+// MAX_REGION_CELLS each). A cell's test only looks at its own window, which
+// lies inside its region and the free cells around it, so any region can be
+// unpruned without invalidating the others: a query unprunes the regions
+// holding its start and goal, and an edit unprunes the regions next to it and
+// erodes that area again.
+class DeadEndIndex {
+public:
+    // Caps how much one query or edit has to unprune.
+    static constexpr size_t MAX_REGION_CELLS = 4096;
+
+    explicit DeadEndIndex(const Grid& grid);
+
+    // Small batches only re-erode around the edited cells; large ones rebuild.
+    void setWalls(const std::vector<CellEdit>& edits);
+
+    bool isPruned(int x, int y) const;
+    size_t prunedCount() const { return prunedCells; }
+    size_t regionCount() const { return members.size(); }
+
+    // Excludes every pruned cell of grid (a copy of the map this index was
+    // built for) except those in the regions of start and end. Searches on
+    // the result find paths exactly as cheap as on the full map.
+    void applyTo(Grid& grid, const Node& start, const Node& end) const;
+
+private:
+    static constexpr uint32_t NO_REGION = (std::numeric_limits<uint32_t>::max)();
+
+    int gridWidth;
+    int gridHeight;
+    std::vector<uint8_t> blocked;
+    CellBitset pruned;
+    std::vector<uint32_t> region;  // Union-find parent of each pruned cell; flattened after every update
+    std::unordered_map<uint32_t, std::vector<uint32_t>> members;  // Cells of each region, by root
+    std::vector<uint8_t> queued;   // Erosion worklist flags, all clear between updates
+    size_t prunedCells = 0;
+
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * gridWidth + x; }
+    bool inBounds(int x, int y) const { return x >= 0 && x < gridWidth && y >= 0 && y < gridHeight; }
+    bool isOpen(int x, int y) const {
+        return inBounds(x, y) && !blocked[index(x, y)] && !pruned.test(index(x, y));
+    }
+    uint32_t regionAt(const Node& cell) const;
+
+    void rebuild();
+    void erode(std::vector<uint32_t> worklist);
+    bool tryPrune(int x, int y);
+    void unpruneRegion(uint32_t root, std::vector<uint32_t>& freed);
+    uint32_t find(uint32_t cell);
+    uint32_t unite(uint32_t a, uint32_t b);
+    void flatten();
+};
\ No newline at end of file
@@ -0,0 +1,951 @@
+// DifferentialFuzzer.cpp
+#include "DifferentialFuzzer.h"
+#include "Constants.h"
+#include "AsyncPathfinder.h"
+#include "AnytimePathFinder.h"
+#include "DistanceMatrix.h"
+#include "ThetaStarPathFinder.h"
+#include "PathfindingStats.h"
+#include "ComponentIndex.h"
+#include "GridSnapshot.h"
+#include "MapEdit.h"
+#include "SearchControl.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+namespace {
+    const int QUERIES_PER_CASE = 16;
+    const size_t MAX_AGENTS = 8;
+    const int MIN_SIDE = 4;
+    const int MAX_SIDE = 96;
+    const int MAP_EDIT_BATCHES = 4;
+    const int PAIRS_PER_BATCH = 8;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point since) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count() / 1000.0;
+    }
+
+    // Drawn from the raw 64-bit stream rather than a std distribution, whose
+    // output differs between standard libraries; seeds must reproduce anywhere.
+    int uniform(std::mt19937_64& random, int low, int high) {
+        return low + static_cast<int>(random() % static_cast<uint64_t>(high - low + 1));
+    }
+
+    bool isFree(const std::vector<std::vector<bool>>& walls, int x, int y) {
+        return y >= 0 && y < static_cast<int>(walls.size()) && x >= 0 && x < static_cast<int>(walls[y].size()) && !walls[y][x];
+    }
+
+    // A diagonal step needs both cells it passes between to be free.
+    bool canStep(const std::vector<std::vector<bool>>& walls, int x, int y, int dx, int dy) {
+        if (!isFree(walls, x + dx, y + dy)) return false;
+        return dx == 0 || dy == 0 || (isFree(walls, x + dx, y) && isFree(walls, x, y + dy));
+    }
+
+    struct ReferenceResult {
+        int cost = -1;
+        size_t expanded = 0;
+    };
+
+    // Textbook Dijkstra on the nested walls: a heap of (cost, x, y) with lazy
+    // deletion and no shared code with the search kernels.
+    ReferenceResult referenceDijkstra(const std::vector<std::vector<bool>>& walls, const Node& start, const Node& end) {
+        const int height = static_cast<int>(walls.size());
+        const int width = height == 0 ? 0 : static_cast<int>(walls[0].size());
+        std::vector<int> cost(static_cast<size_t>(width) * height, -1);
+        std::vector<uint8_t> settled(cost.size(), 0);
+        using Entry = std::tuple<int, int, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        ReferenceResult result;
+
+        cost[static_cast<size_t>(start.y) * width + start.x] = 0;
+        open.push({ 0, start.x, start.y });
+        while (!open.empty()) {
+            auto [g, x, y] = open.top();
+            open.pop();
+            size_t cell = static_cast<size_t>(y) * width + x;
+            if (settled[cell]) continue;
+            settled[cell] = 1;
+            result.expanded++;
+            if (x == end.x && y == end.y) {
+                result.cost = g;
+                break;
+            }
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if ((dx == 0 && dy == 0) || !canStep(walls, x, y, dx, dy)) continue;
+                    int next = g + (dx != 0 && dy != 0 ? Constants::DIAGONAL_COST : Constants::STRAIGHT_COST);
+                    size_t neighbor = static_cast<size_t>(y + dy) * width + x + dx;
+                    if (cost[neighbor] < 0 || next < cost[neighbor]) {
+                        cost[neighbor] = next;
+                        open.push({ next, x + dx, y + dy });
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Fewest moves from start to end by plain breadth-first search, -1 if unreachable.
+    int referenceMoves(const std::vector<std::vector<bool>>& walls, const Node& start, const Node& end) {
+        const int height = static_cast<int>(walls.size());
+        const int width = height == 0 ? 0 : static_cast<int>(walls[0].size());
+        std::vector<int> moves(static_cast<size_t>(width) * height, -1);
+        std::queue<Node> frontier;
+        moves[static_cast<size_t>(start.y) * width + start.x] = 0;
+        frontier.push(start);
+        while (!frontier.empty()) {
+            Node current = frontier.front();
+            frontier.pop();
+            int here = moves[static_cast<size_t>(current.y) * width + current.x];
+            if (current == end) return here;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if ((dx == 0 && dy == 0) || !canStep(walls, current.x, current.y, dx, dy)) continue;
+                    size_t neighbor = static_cast<size_t>(current.y + dy) * width + current.x + dx;
+                    if (moves[neighbor] < 0) {
+                        moves[neighbor] = here + 1;
+                        frontier.push(Node{ current.x + dx, current.y + dy });
+                    }
+                }
+            }
+        }
+        return -1;
+    }
+
+    void fillRect(std::vector<std::vector<bool>>& walls, int left, int top, int right, int bottom, bool wall) {
+        for (int y = (std::max)(top, 0); y < (std::min)(bottom, static_cast<int>(walls.size())); y++) {
+            for (int x = (std::max)(left, 0); x < (std::min)(right, static_cast<int>(walls[y].size())); x++) {
+                walls[y][x] = wall;
+            }
+        }
+    }
+
+    // Path of a scratch file for one case's stage, removed when it goes away.
+    class ScratchFile {
+    public:
+        ScratchFile(uint64_t seed, const std::string& name)
+            : path((std::filesystem::temp_directory_path() / ("pathfinding_fuzz_" + std::to_string(seed) + "_" + name)).string()) {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+        ~ScratchFile() {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+
+        const std::string path;
+    };
+
+    // Writes run "a" in two parts, cuts the second part's chunk short at a
+    // random byte as a crash would, and appends run "b": the writer has to cut
+    // the torn chunk off so that both runs load. Then tears the file again and
+    // puts a chunk of "b" behind the tear by hand, as in a file torn before
+    // writers trimmed: loading has to report the damage and still find "b".
+    std::optional<std::string> checkStatsRecovery(const FuzzCase& fuzzCase) {
+        std::mt19937_64 random(fuzzCase.seed);
+        ScratchFile file(fuzzCase.seed, "stats.bin");
+        ScratchFile extra(fuzzCase.seed, "stats_extra.bin");
+        std::vector<std::pair<std::string, uint32_t>> expected;  // Run and nodes expanded per row
+        auto write = [&](const std::string& path, const std::string& run, uint32_t first, uint32_t rows, size_t chunkRows) {
+            StatsWriter writer(path, run, chunkRows);
+            for (uint32_t i = 0; i < rows; i++) {
+                writer.append("fuzz", fuzzCase.seed, 0, 0, Node{ 0, 0 }, Node{ 0, 0 }, 0, first + i, 0.0);
+            }
+            return writer.flush();
+        };
+        auto check = [&](bool intact, const std::string& step) -> std::optional<std::string> {
+            StatsTable table;
+            if (table.loadFile(file.path) != intact) {
+                return step + ": load reported the file " + (intact ? "damaged" : "intact");
+            }
+            if (table.size() != expected.size()) {
+                return step + ": loaded " + std::to_string(table.size()) + " rows, expected " + std::to_string(expected.size());
+            }
+            for (size_t row = 0; row < expected.size(); row++) {
+                if (table.text(table.run[row]) != expected[row].first || table.nodesExpanded[row] != expected[row].second) {
+                    return step + ": row " + std::to_string(row) + " differs";
+                }
+            }
+            return std::nullopt;
+        };
+        auto tear = [&](uint32_t first) {
+            uint32_t rows = static_cast<uint32_t>(uniform(random, 1, 40));
+            uint64_t whole = std::filesystem::file_size(file.path);
+            write(file.path, "a", first, rows, rows);  // One chunk
+            std::filesystem::resize_file(file.path, whole + uniform(random, 1, static_cast<int>(std::filesystem::file_size(file.path) - whole) - 1));
+        };
+
+        uint32_t rows = static_cast<uint32_t>(uniform(random, 1, 100));
+        if (!write(file.path, "a", 0, rows, uniform(random, 1, 16))) {
+            return std::string("could not write the stats file");
+        }
+        for (uint32_t i = 0; i < rows; i++) {
+            expected.push_back({ "a", i });
+        }
+        tear(rows);
+        rows = static_cast<uint32_t>(uniform(random, 1, 100));
+        write(file.path, "b", 1000, rows, uniform(random, 1, 16));
+        for (uint32_t i = 0; i < rows; i++) {
+            expected.push_back({ "b", 1000 + i });
+        }
+        if (std::optional<std::string> problem = check(true, "append after a tear")) {
+            return problem;
+        }
+
+        tear(2000);
+        rows = static_cast<uint32_t>(uniform(random, 1, 100));
+        write(extra.path, "b", 3000, rows, rows);
+        {
+            std::ifstream chunk(extra.path, std::ios::binary);
+            std::ofstream out(file.path, std::ios::binary | std::ios::app);
+            out << chunk.rdbuf();
+        }
+        for (uint32_t i = 0; i < rows; i++) {
+            expected.push_back({ "b", 3000 + i });
+        }
+        return check(false, "chunk behind a tear");
+    }
+
+    // Traces an A* query into a small event log, so that long searches wrap
+    // its ring, saves and loads it, and compares the decoded events. Then
+    // damages the file's counts and length: every damaged file must be
+    // rejected rather than sizing anything by the bad counts.
+    std::optional<std::string> checkEventLog(const FuzzCase& fuzzCase, const FuzzMap& map) {
+        if (fuzzCase.queries.empty()) {
+            return std::nullopt;
+        }
+        std::mt19937_64 random(fuzzCase.seed);
+        ScratchFile file(fuzzCase.seed, "events.bin");
+        const auto& [start, end] = fuzzCase.queries.back();
+        SearchEventLog log(map.grid.width(), SearchEventLog::BLOCK_SIZE * uniform(random, 1, 4));
+        SearchControl control;
+        control.setEventLog(&log);
+        AsyncPathfinder::runQuery(map.grid, PathQuery{ "A*", start, end, TieBreakPolicy::None, false, nullptr }, &control);
+
+        if (!log.saveToFile(file.path)) {
+            return std::string("could not write the event log");
+        }
+        std::optional<SearchEventLog> loaded = SearchEventLog::loadFromFile(file.path);
+        if (!loaded) {
+            return std::string("saved event log did not load");
+        }
+        if (loaded->width() != log.width() || loaded->eventCount() != log.eventCount() ||
+            loaded->droppedEvents() != log.droppedEvents()) {
+            return "loaded " + std::to_string(loaded->eventCount()) + " events, " + std::to_string(loaded->droppedEvents()) +
+                " dropped; saved " + std::to_string(log.eventCount()) + ", " + std::to_string(log.droppedEvents());
+        }
+        std::vector<SearchEvent> saved = log.decode();
+        std::vector<SearchEvent> decoded = loaded->decode();
+        for (size_t i = 0; i < saved.size(); i++) {
+            if (i >= decoded.size() || decoded[i].type != saved[i].type || !(decoded[i].node == saved[i].node) ||
+                decoded[i].timeNs != saved[i].timeNs) {
+                return "decoded event " + std::to_string(i) + " differs from the one saved";
+            }
+        }
+        if (decoded.size() != saved.size()) {
+            return "decoded " + std::to_string(decoded.size()) + " events, saved " + std::to_string(saved.size());
+        }
+
+        // Header: magic, version, width, block count, dropped; then the first
+        // block's event count
+        const std::streamoff BLOCK_COUNT_OFFSET = 12;
+        const std::streamoff FIRST_EVENTS_OFFSET = 28;
+        auto damaged = [&](const std::string& damage, auto&& corrupt) -> std::optional<std::string> {
+            log.saveToFile(file.path);
+            corrupt();
+            if (SearchEventLog::loadFromFile(file.path)) {
+                return "event log with " + damage + " loaded";
+            }
+            return std::nullopt;
+        };
+        auto patch = [&](std::streamoff offset, uint64_t value) {
+            std::fstream out(file.path, std::ios::binary | std::ios::in | std::ios::out);
+            out.seekp(offset);
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        const uint64_t size = std::filesystem::file_size(file.path);
+        if (auto problem = damaged("a huge block count", [&] { patch(BLOCK_COUNT_OFFSET, random() | (1ull << 40)); })) {
+            return problem;
+        }
+        if (auto problem = damaged("a block count past its end", [&] { patch(BLOCK_COUNT_OFFSET, size); })) {
+            return problem;
+        }
+        if (auto problem = damaged("a huge event count", [&] { patch(FIRST_EVENTS_OFFSET, random() | (1ull << 40)); })) {
+            return problem;
+        }
+        return damaged("a cut off end", [&] {
+            std::filesystem::resize_file(file.path, static_cast<uint64_t>(uniform(random, 0, static_cast<int>(size) - 1)));
+        });
+    }
+
+    // Checks the cells line() added: a walk of 8-connected steps from one
+    // end to the other, one cell per step along the longer axis.
+    bool isLine(const std::vector<CellEdit>& edits, size_t first, int fromX, int fromY, int toX, int toY, bool wall) {
+        size_t cells = static_cast<size_t>((std::max)(std::abs(toX - fromX), std::abs(toY - fromY))) + 1;
+        if (edits.size() - first != cells || edits[first].x != fromX || edits[first].y != fromY ||
+            edits.back().x != toX || edits.back().y != toY) {
+            return false;
+        }
+        for (size_t i = first; i < edits.size(); i++) {
+            if (edits[i].wall != wall) return false;
+            if (i > first && (std::max)(std::abs(edits[i].x - edits[i - 1].x), std::abs(edits[i].y - edits[i - 1].y)) != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Adds a few random wall edits to batch: cells, strokes, rectangles,
+    // stamped bitmaps and edits appended from another batch, some of them
+    // running off the map, which applying the batch has to skip. Large
+    // rectangles take the indexes' rebuild path rather than the incremental
+    // one. Paints what each edit should do onto expected.
+    std::optional<std::string> randomBatch(std::mt19937_64& random, std::vector<std::vector<bool>>& expected, MapEditBatch& batch) {
+        const int height = static_cast<int>(expected.size());
+        const int width = height == 0 ? 0 : static_cast<int>(expected[0].size());
+        auto x = [&] { return uniform(random, -2, width + 1); };
+        auto y = [&] { return uniform(random, -2, height + 1); };
+        auto paint = [&](int cellX, int cellY, bool wall) {
+            fillRect(expected, cellX, cellY, cellX + 1, cellY + 1, wall);
+        };
+        auto line = [&](MapEditBatch& target, bool wall) {
+            int fromX = x(), fromY = y(), toX = x(), toY = y();
+            size_t first = target.size();
+            target.line(fromX, fromY, toX, toY, wall);
+            for (size_t i = first; i < target.size(); i++) {
+                paint(target.edits()[i].x, target.edits()[i].y, wall);
+            }
+            return isLine(target.edits(), first, fromX, fromY, toX, toY, wall);
+        };
+        for (int edits = uniform(random, 1, 6); edits > 0; edits--) {
+            bool wall = uniform(random, 0, 2) != 0;
+            switch (uniform(random, 0, 5)) {
+            case 0: {
+                int cellX = x(), cellY = y();
+                batch.set(cellX, cellY, wall);
+                paint(cellX, cellY, wall);
+                break;
+            }
+            case 1:
+                if (!line(batch, wall)) {
+                    return std::string("line() is not a connected line between its ends");
+                }
+                break;
+            case 2:
+            case 3: {
+                int left = x(), top = y();
+                CellRect rect{ left, top, left + uniform(random, 0, 40), top + uniform(random, 0, 40) };
+                if (wall) {
+                    batch.fillRect(rect, true);
+                }
+                else {
+                    batch.clearRect(rect);
+                }
+                fillRect(expected, rect.left, rect.top, rect.right, rect.bottom, wall);
+                break;
+            }
+            case 4: {
+                int left = x(), top = y();
+                std::vector<std::vector<bool>> bitmap(uniform(random, 1, 8), std::vector<bool>(uniform(random, 1, 8)));
+                for (int row = 0; row < static_cast<int>(bitmap.size()); row++) {
+                    for (int column = 0; column < static_cast<int>(bitmap[row].size()); column++) {
+                        bitmap[row][column] = uniform(random, 0, 1) != 0;
+                        paint(left + column, top + row, bitmap[row][column]);
+                    }
+                }
+                batch.stamp(left, top, bitmap);
+                break;
+            }
+            default: {
+                MapEditBatch other;
+                if (!line(other, wall)) {
+                    return std::string("line() is not a connected line between its ends");
+                }
+                batch.append(other.edits());
+                break;
+            }
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Edits the case's map in batches the way World::applyEdits does, checks
+    // the walls they leave, and after each batch compares what was updated incrementally with the edited
+    // walls: the published snapshot, ComponentIndex::connected() against a
+    // fresh index, and Dijkstra on the snapshot with dead ends pruned against
+    // without, and against the reference.
+    std::optional<std::string> checkMapEdits(const FuzzCase& fuzzCase, const FuzzMap& map) {
+        std::mt19937_64 random(fuzzCase.seed);
+        std::vector<std::vector<bool>> walls = fuzzCase.walls;
+        std::vector<std::vector<bool>> expected = walls;
+        const int height = static_cast<int>(walls.size());
+        const int width = height == 0 ? 0 : static_cast<int>(walls[0].size());
+        ComponentIndex components(map.grid, 1);
+        std::shared_ptr<const DeadEndIndex> deadEnds = map.deadEnds;
+        VersionedGrid versions(walls);
+
+        for (int round = 0; round < MAP_EDIT_BATCHES; round++) {
+            const std::string step = "batch " + std::to_string(round);
+            MapEditBatch batch;
+            if (std::optional<std::string> problem = randomBatch(random, expected, batch)) {
+                return step + ": " + *problem;
+            }
+            std::vector<CellEdit> changed = batch.applyTo(walls);
+            if (walls != expected) {
+                return step + ": applying the batch left different walls than its edits describe";
+            }
+            if (!changed.empty()) {
+                components.setWalls(changed);
+                auto updatedDeadEnds = std::make_shared<DeadEndIndex>(*deadEnds);
+                updatedDeadEnds->setWalls(changed);
+                deadEnds = std::move(updatedDeadEnds);
+                versions.publish(changed);
+            }
+
+            std::shared_ptr<const GridSnapshot> snapshot = versions.current();
+            if (snapshot->toWalls() != walls) {
+                return step + ": snapshot walls differ from the edited walls";
+            }
+
+            ComponentIndex fresh(Grid(walls), 1);
+            std::vector<Node> freeCells;
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    if (!walls[y][x]) {
+                        freeCells.push_back(Node{ x, y });
+                    }
+                }
+            }
+            for (int pair = 0; pair < PAIRS_PER_BATCH; pair++) {
+                Node a{ uniform(random, 0, width - 1), uniform(random, 0, height - 1) };
+                Node b{ uniform(random, 0, width - 1), uniform(random, 0, height - 1) };
+                if (components.connected(a, b) != fresh.connected(a, b)) {
+                    return step + ": connected(" + std::to_string(a.x) + "," + std::to_string(a.y) + ", " +
+                        std::to_string(b.x) + "," + std::to_string(b.y) + ") disagrees with a fresh index";
+                }
+                if (freeCells.empty()) {
+                    continue;
+                }
+
+                Node start = freeCells[uniform(random, 0, static_cast<int>(freeCells.size()) - 1)];
+                Node end = freeCells[uniform(random, 0, static_cast<int>(freeCells.size()) - 1)];
+                PathQuery query{ "Dijkstra", start, end, TieBreakPolicy::None, false, nullptr };
+                SearchResult full = AsyncPathfinder::runQuery(*snapshot->grid(), query);
+                query.deadEnds = deadEnds;
+                SearchResult pruned = AsyncPathfinder::runQuery(*snapshot->grid(), query);
+                int reference = referenceDijkstra(walls, start, end).cost;
+                if (full.cost != reference || pruned.cost != reference) {
+                    return step + ": Dijkstra " + std::to_string(start.x) + "," + std::to_string(start.y) + " -> " +
+                        std::to_string(end.x) + "," + std::to_string(end.y) + " cost " + std::to_string(full.cost) +
+                        ", pruned " + std::to_string(pruned.cost) + ", reference " + std::to_string(reference);
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    SearchResult runNamed(const std::string& algorithm, const FuzzMap& map, const Node& start, const Node& end,
+        TieBreakPolicy tieBreak = TieBreakPolicy::None, bool pruned = false) {
+        PathQuery query{ algorithm, start, end, tieBreak, false, nullptr };
+        if (pruned) {
+            query.deadEnds = map.deadEnds;
+        }
+        return AsyncPathfinder::runQuery(map.grid, query);
+    }
+}
+
+FuzzCase FuzzCase::generate(uint64_t seed) {
+    std::mt19937_64 random(seed);
+    FuzzCase fuzzCase;
+    fuzzCase.seed = seed;
+    const int width = uniform(random, MIN_SIDE, MAX_SIDE);
+    const int height = uniform(random, MIN_SIDE, MAX_SIDE);
+    auto& walls = fuzzCase.walls;
+    walls.assign(height, std::vector<bool>(width, false));
+
+    switch (uniform(random, 0, 3)) {
+    case 0: {
+        int density = uniform(random, 5, 45);
+        for (auto& row : walls) {
+            for (size_t x = 0; x < row.size(); x++) {
+                row[x] = uniform(random, 0, 99) < density;
+            }
+        }
+        fuzzCase.kind = "noise " + std::to_string(density) + "%";
+        break;
+    }
+    case 1: {
+        // Overlapping room outlines, each with a door or two
+        int rooms = uniform(random, 1, 12);
+        for (int i = 0; i < rooms; i++) {
+            int left = uniform(random, -2, width - 1);
+            int top = uniform(random, -2, height - 1);
+            int right = left + uniform(random, 3, 30);
+            int bottom = top + uniform(random, 3, 30);
+            fillRect(walls, left, top, right, top + 1, true);
+            fillRect(walls, left, bottom - 1, right, bottom, true);
+            fillRect(walls, left, top, left + 1, bottom, true);
+            fillRect(walls, right - 1, top, right, bottom, true);
+            for (int door = uniform(random, 1, 2); door > 0; door--) {
+                int x = uniform(random, left, right - 1);
+                int y = uniform(random, top, bottom - 1);
+                fillRect(walls, x, y, x + uniform(random, 1, 2), y + uniform(random, 1, 2), false);
+            }
+        }
+        fuzzCase.kind = "rooms";
+        break;
+    }
+    case 2: {
+        // Long wall segments with gaps
+        int segments = uniform(random, 1, 40);
+        for (int i = 0; i < segments; i++) {
+            int x = uniform(random, 0, width - 1);
+            int y = uniform(random, 0, height - 1);
+            int length = uniform(random, 2, 40);
+            if (uniform(random, 0, 1)) {
+                fillRect(walls, x, y, x + length, y + 1, true);
+            }
+            else {
+                fillRect(walls, x, y, x + 1, y + length, true);
+            }
+        }
+        fuzzCase.kind = "walls";
+        break;
+    }
+    default: {
+        // Shelving: rows of cul-de-sacs closed at one end
+        int pitch = uniform(random, 2, 5);
+        int depth = uniform(random, 3, 12);
+        for (int top = 1; top + depth < height; top += depth + 3) {
+            for (int x = 1; x < width; x += pitch) {
+                fillRect(walls, x, top, x + 1, top + depth, true);
+            }
+            fillRect(walls, 1, top + depth - 1, width - 1, top + depth, true);
+        }
+        fuzzCase.kind = "shelves";
+        break;
+    }
+    }
+
+    std::vector<Node> freeCells;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (!walls[y][x]) {
+                freeCells.push_back(Node{ x, y });
+            }
+        }
+    }
+    if (!freeCells.empty()) {
+        for (int i = 0; i < QUERIES_PER_CASE; i++) {
+            Node start = freeCells[uniform(random, 0, static_cast<int>(freeCells.size()) - 1)];
+            Node end = i == 0 ? start : freeCells[uniform(random, 0, static_cast<int>(freeCells.size()) - 1)];
+            fuzzCase.queries.push_back({ start, end });
+        }
+    }
+    return fuzzCase;
+}
+
+FuzzMap::FuzzMap(const FuzzCase& fuzzCase)
+    : walls(fuzzCase.walls),
+    grid(fuzzCase.walls, fuzzCase.seed % 2 ? CellLayout::Tiled8x8 : CellLayout::RowMajor),
+    deadEnds(std::make_shared<const DeadEndIndex>(grid)) {
+}
+
+DifferentialFuzzer::DifferentialFuzzer(std::vector<FuzzFinder> finders) : finders(std::move(finders)) {
+    for (const FuzzFinder& finder : this->finders) {
+        finderStats.push_back(FuzzFinderStats{ finder.name });
+    }
+    finderStats.push_back(FuzzFinderStats{ "Cooperative A*" });
+    finderStats.push_back(FuzzFinderStats{ "Stats file" });
+    finderStats.push_back(FuzzFinderStats{ "Map edits" });
+    finderStats.push_back(FuzzFinderStats{ "Event log" });
+}
+
+std::vector<FuzzFinder> DifferentialFuzzer::defaultFinders() {
+    using Expect = FuzzExpectation;
+    const double bound = 1.0 + Constants::BOUNDED_SEARCH_EPSILON;
+    std::vector<FuzzFinder> finders = {
+        { "Dijkstra", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("Dijkstra", map, s, e);
+        } },
+        { "A*", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("A*", map, s, e);
+        } },
+        { "JPS", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("JPS", map, s, e);
+        } },
+        { "Greedy", Expect::AnyPath, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("Greedy", map, s, e);
+        } },
+        { "BFS", Expect::FewestMoves, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("BFS", map, s, e);
+        } },
+        { "Theta*", Expect::AnyAngle, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("Theta*", map, s, e);
+        } },
+        { "Theta* (eager)", Expect::AnyAngle, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return ThetaStarPathFinder::search(map.grid, s, e, false).search;
+        } },
+        { "Dijkstra (pruned)", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("Dijkstra", map, s, e, TieBreakPolicy::None, true);
+        } },
+        { "A* (pruned)", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("A*", map, s, e, TieBreakPolicy::None, true);
+        } },
+        { "Greedy (pruned)", Expect::AnyPath, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("Greedy", map, s, e, TieBreakPolicy::None, true);
+        } },
+        { "Weighted A*", Expect::Bounded, bound, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return AStarPathFinder::findPathWeighted(map.grid, s, e, Constants::BOUNDED_SEARCH_EPSILON);
+        } },
+        { "Focal", Expect::Bounded, bound, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return AStarPathFinder::findPathFocal(map.grid, s, e, Constants::BOUNDED_SEARCH_EPSILON);
+        } },
+        { "Anytime A*", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            AnytimePathFinder finder(map.grid, s, e);
+            return finder.improve(SearchBudget::unlimited());
+        } },
+        { "Nearest target", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return AStarPathFinder::searchNearest(map.grid, s, { e });
+        } },
+        { "Compact A*", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            return runNamed("Compact A*", map, s, e);
+        } },
+        { "A* (memory cap)", Expect::Optimal, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            // Capped at exactly what Compact A* needs for this query, which is
+            // below A*'s 8 bytes a cell on all but open maps, so A* stops and
+            // the fallback has to fit the cap
+            size_t compactPeak = runNamed("Compact A*", map, s, e).memory.peakBytes;
+            PathQuery query{ "A*", s, e, TieBreakPolicy::None, false, nullptr, compactPeak, true };
+            return AsyncPathfinder::runQuery(map.grid, query);
+        } },
+        { "Distance matrix", Expect::OptimalCost, 1.0, [](const FuzzMap& map, const Node& s, const Node& e) {
+            DistanceMatrix matrix = DistanceMatrix::compute(map.grid, { s }, { e }, 1);
+            SearchResult result;
+            result.cost = matrix.at(0, 0);
+            result.status = result.cost == DistanceMatrix::UNREACHABLE ? SearchStatus::NoPath : SearchStatus::Found;
+            result.memory = matrix.memory();
+            return result;
+        } },
+    };
+
+    for (TieBreakPolicy policy : { TieBreakPolicy::HigherG, TieBreakPolicy::CrossProduct, TieBreakPolicy::Fifo, TieBreakPolicy::Lifo }) {
+        finders.push_back({ std::string("A* (") + tieBreakPolicyName(policy) + ")", Expect::Optimal, 1.0,
+            [policy](const FuzzMap& map, const Node& s, const Node& e) {
+                return runNamed("A*", map, s, e, policy);
+            } });
+    }
+    return finders;
+}
+
+std::vector<FuzzFailure> DifferentialFuzzer::runCase(const FuzzCase& fuzzCase) {
+    FuzzMap map(fuzzCase);
+    std::vector<FuzzFailure> failures;
+    const uint64_t mapId = recorder ? PathfindingStats::generateMapId(fuzzCase.walls) : 0;
+    auto record = [&](const std::string& name, const Node& start, const Node& end, size_t pathLength,
+        size_t expanded, double ms, uint64_t peakBytes) {
+        if (recorder) {
+            recorder->append(name, mapId, map.grid.width(), map.grid.height(), start, end, pathLength, expanded, ms,
+                peakBytes);
+        }
+    };
+
+    for (const auto& [start, end] : fuzzCase.queries) {
+        auto referenceStart = Clock::now();
+        ReferenceResult reference = referenceDijkstra(fuzzCase.walls, start, end);
+        double referenceMs = elapsedMs(referenceStart);
+        int moves = referenceMoves(fuzzCase.walls, start, end);
+        record("Reference Dijkstra", start, end, 0, reference.expanded, referenceMs, 0);
+
+        for (size_t f = 0; f < finders.size(); f++) {
+            const FuzzFinder& finder = finders[f];
+            FuzzFinderStats& stats = finderStats[f];
+            std::optional<std::string> problem;
+
+            auto startTime = Clock::now();
+            try {
+                SearchResult result = finder.run(map, start, end);
+                double ms = elapsedMs(startTime);
+                stats.timeMs += ms;
+                stats.nodesExpanded += result.nodesExpanded;
+                record(finder.name, start, end, result.path.size(), result.nodesExpanded, ms, result.memory.peakBytes);
+                problem = checkResult(finder, map, start, end, result, reference.cost, moves);
+            }
+            catch (const std::exception& error) {
+                problem = std::string("threw ") + error.what();
+            }
+            stats.queries++;
+            stats.referenceExpanded += reference.expanded;
+            stats.referenceMs += referenceMs;
+
+            if (problem) {
+                stats.failures++;
+                failures.push_back(FuzzFailure{ fuzzCase.seed, finder.name, start, end, *problem });
+            }
+        }
+    }
+    if (std::optional<FuzzFailure> failure = runAgents(fuzzCase, map)) {
+        failures.push_back(*failure);
+    }
+    if (std::optional<FuzzFailure> failure = runStage(StatsFileStage, fuzzCase, 1,
+        [&] { return checkStatsRecovery(fuzzCase); })) {
+        failures.push_back(*failure);
+    }
+    if (std::optional<FuzzFailure> failure = runStage(MapEditsStage, fuzzCase, MAP_EDIT_BATCHES,
+        [&] { return checkMapEdits(fuzzCase, map); })) {
+        failures.push_back(*failure);
+    }
+    if (std::optional<FuzzFailure> failure = runStage(EventLogStage, fuzzCase, 1,
+        [&] { return checkEventLog(fuzzCase, map); })) {
+        failures.push_back(*failure);
+    }
+    return failures;
+}
+
+std::optional<FuzzFailure> DifferentialFuzzer::runStage(Stage stage, const FuzzCase& fuzzCase, size_t queries,
+    const std::function<std::optional<std::string>()>& check) {
+    FuzzFinderStats& stats = stageStats(stage);
+    std::optional<std::string> problem;
+    auto startTime = Clock::now();
+    try {
+        problem = check();
+    }
+    catch (const std::exception& error) {
+        problem = std::string("threw ") + error.what();
+    }
+    stats.timeMs += elapsedMs(startTime);
+    stats.queries += queries;
+
+    if (!problem) {
+        return std::nullopt;
+    }
+    stats.failures++;
+    return FuzzFailure{ fuzzCase.seed, stats.name, Node{ 0, 0 }, Node{ 0, 0 }, *problem };
+}
+
+// Agents take the queries in order, skipping any whose start or goal another
+// agent already has. Expansions are not compared with anything; failures are
+// counted per case.
+std::optional<FuzzFailure> DifferentialFuzzer::runAgents(const FuzzCase& fuzzCase, const FuzzMap& map) {
+    std::vector<AgentTask> agents;
+    for (const auto& [start, end] : fuzzCase.queries) {
+        bool taken = std::any_of(agents.begin(), agents.end(), [&](const AgentTask& agent) {
+            return agent.start == start || agent.goal == end;
+        });
+        if (!taken && agents.size() < MAX_AGENTS) {
+            agents.push_back(AgentTask{ start, end });
+        }
+    }
+    if (agents.empty()) {
+        return std::nullopt;
+    }
+
+    FuzzFinderStats& stats = stageStats(CooperativeStage);
+    std::optional<std::string> problem;
+    auto startTime = Clock::now();
+    try {
+        std::vector<SearchResult> plans = CooperativePathFinder::plan(map.grid, agents);
+        stats.timeMs += elapsedMs(startTime);
+        for (const SearchResult& plan : plans) {
+            stats.nodesExpanded += plan.nodesExpanded;
+        }
+        problem = checkPlans(fuzzCase.walls, agents, plans);
+    }
+    catch (const std::exception& error) {
+        problem = std::string("threw ") + error.what();
+    }
+    stats.queries += agents.size();
+
+    if (!problem) {
+        return std::nullopt;
+    }
+    stats.failures++;
+    return FuzzFailure{ fuzzCase.seed, stats.name, agents.front().start, agents.front().goal, *problem };
+}
+
+std::optional<std::string> DifferentialFuzzer::checkResult(
+    const FuzzFinder& finder,
+    const FuzzMap& map,
+    const Node& start,
+    const Node& end,
+    const SearchResult& result,
+    int referenceCost,
+    int referenceMoves
+) const {
+    std::stringstream problem;
+    bool found = result.status == SearchStatus::Found;
+    if (found != (referenceCost >= 0)) {
+        if (found) {
+            problem << "found a path (cost " << result.cost << ") where there is none";
+        }
+        else {
+            problem << "found no path, reference cost " << referenceCost;
+        }
+        return problem.str();
+    }
+    if (!found) {
+        return std::nullopt;
+    }
+
+    if (finder.expectation == FuzzExpectation::OptimalCost) {
+        if (result.cost != referenceCost) {
+            problem << "cost " << result.cost << ", reference " << referenceCost;
+            return problem.str();
+        }
+        return std::nullopt;
+    }
+
+    if (std::optional<std::string> invalid = checkPath(map.walls, start, end, result.path)) {
+        return invalid;
+    }
+
+    int pathCost = gridPathCost(result.path);
+    switch (finder.expectation) {
+    case FuzzExpectation::Optimal:
+        if (result.cost != referenceCost || pathCost != referenceCost) {
+            problem << "cost " << result.cost << " (path " << pathCost << "), reference " << referenceCost;
+        }
+        break;
+    case FuzzExpectation::Bounded:
+        if (result.cost != pathCost) {
+            problem << "reported cost " << result.cost << ", path costs " << pathCost;
+        }
+        else if (result.cost > finder.bound * referenceCost + 1e-9) {
+            problem << "cost " << result.cost << " above " << finder.bound << " x reference " << referenceCost;
+        }
+        else if (result.lowerBound > referenceCost) {
+            problem << "lower bound " << result.lowerBound << " above reference " << referenceCost;
+        }
+        break;
+    case FuzzExpectation::FewestMoves:
+        if (static_cast<int>(result.path.size()) - 1 != referenceMoves) {
+            problem << result.path.size() - 1 << " moves, fewest " << referenceMoves;
+        }
+        break;
+    case FuzzExpectation::AnyAngle: {
+        // Any-angle paths can only beat the grid, never the straight line. The
+        // grid costs round a diagonal down to DIAGONAL_COST, so the reference
+        // is scaled to true Euclidean diagonals (at most) first; costs are
+        // rounded to whole units, hence the slack of one.
+        double straight = Constants::STRAIGHT_COST * std::hypot(end.x - start.x, end.y - start.y);
+        double gridLength = referenceCost * Constants::STRAIGHT_COST * std::sqrt(2.0) / Constants::DIAGONAL_COST;
+        if (result.cost > gridLength + 1 || result.cost + 1 < straight) {
+            problem << "cost " << result.cost << " outside [" << straight << ", " << gridLength << "]";
+        }
+        break;
+    }
+    case FuzzExpectation::AnyPath:
+        if (result.cost != pathCost) {
+            problem << "reported cost " << result.cost << ", path costs " << pathCost;
+        }
+        break;
+    default:
+        break;
+    }
+    std::string text = problem.str();
+    return text.empty() ? std::nullopt : std::optional<std::string>(text);
+}
+
+std::optional<std::string> DifferentialFuzzer::checkPath(
+    const std::vector<std::vector<bool>>& walls,
+    const Node& start,
+    const Node& end,
+    const std::vector<Node>& path
+) {
+    std::stringstream problem;
+    if (path.empty() || !(path.front() == start) || !(path.back() == end)) {
+        problem << "path of " << path.size() << " cells does not run from start to end";
+        return problem.str();
+    }
+    for (size_t i = 0; i < path.size(); i++) {
+        if (!isFree(walls, path[i].x, path[i].y)) {
+            problem << "cell " << i << " (" << path[i].x << "," << path[i].y << ") is a wall";
+            return problem.str();
+        }
+        if (i == 0) continue;
+        int dx = path[i].x - path[i - 1].x;
+        int dy = path[i].y - path[i - 1].y;
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) {
+            problem << "step " << i << " from (" << path[i - 1].x << "," << path[i - 1].y << ") to ("
+                << path[i].x << "," << path[i].y << ") is not a move";
+            return problem.str();
+        }
+        if (!canStep(walls, path[i - 1].x, path[i - 1].y, dx, dy)) {
+            problem << "step " << i << " cuts the corner at (" << path[i - 1].x << "," << path[i - 1].y << ")";
+            return problem.str();
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> DifferentialFuzzer::checkPlans(
+    const std::vector<std::vector<bool>>& walls,
+    const std::vector<AgentTask>& agents,
+    const std::vector<SearchResult>& plans
+) {
+    std::stringstream problem;
+    if (plans.size() != agents.size()) {
+        problem << plans.size() << " plans for " << agents.size() << " agents";
+        return problem.str();
+    }
+
+    size_t horizon = 1;
+    for (size_t a = 0; a < agents.size(); a++) {
+        const std::vector<Node>& path = plans[a].path;
+        if (plans[a].status != SearchStatus::Found) {
+            continue;
+        }
+        if (path.empty() || !(path.front() == agents[a].start) || !(path.back() == agents[a].goal)) {
+            problem << "agent " << a << ": plan of " << path.size() << " steps does not run from start to goal";
+            return problem.str();
+        }
+        int cost = 0;
+        for (size_t t = 1; t < path.size(); t++) {
+            int dx = path[t].x - path[t - 1].x;
+            int dy = path[t].y - path[t - 1].y;
+            bool wait = dx == 0 && dy == 0;
+            if (std::abs(dx) > 1 || std::abs(dy) > 1 || (!wait && !canStep(walls, path[t - 1].x, path[t - 1].y, dx, dy))) {
+                problem << "agent " << a << ": step " << t << " to (" << path[t].x << "," << path[t].y << ") is not a move";
+                return problem.str();
+            }
+            cost += dx != 0 && dy != 0 ? Constants::DIAGONAL_COST : Constants::STRAIGHT_COST;
+        }
+        if (cost != plans[a].cost) {
+            problem << "agent " << a << ": reported cost " << plans[a].cost << ", plan costs " << cost;
+            return problem.str();
+        }
+        horizon = (std::max)(horizon, path.size());
+    }
+
+    auto cellAt = [&](size_t a, size_t t) {
+        const std::vector<Node>& path = plans[a].path;
+        if (plans[a].status != SearchStatus::Found) return agents[a].start;
+        return path[(std::min)(t, path.size() - 1)];
+    };
+    for (size_t t = 0; t < horizon; t++) {
+        for (size_t a = 0; a < agents.size(); a++) {
+            for (size_t b = a + 1; b < agents.size(); b++) {
+                if (cellAt(a, t) == cellAt(b, t)) {
+                    problem << "agents " << a << " and " << b << " both on (" << cellAt(a, t).x << ","
+                        << cellAt(a, t).y << ") at step " << t;
+                    return problem.str();
+                }
+                if (cellAt(a, t) == cellAt(b, t + 1) && cellAt(b, t) == cellAt(a, t + 1)) {
+                    problem << "agents " << a << " and " << b << " swap cells at step " << t;
+                    return problem.str();
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
\ No newline at end of file
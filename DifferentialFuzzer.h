@@ -0,0 +1,149 @@
+// DifferentialFuzzer.h
+#pragma once
+#include "Node.h"
+#include "Grid.h"
+#include "BestFirstSearch.h"
+#include "DeadEndIndex.h"
+#include "CooperativePathFinder.h"
+#include "StatsStore.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+// A random map and queries on it; everything is derived from the seed, so a
+// seed is all it takes to reproduce a failure.
+struct FuzzCase {
+    uint64_t seed = 0;
+    std::string kind;  // Map generator used, e.g. "noise 30%" or "rooms"
+    std::vector<std::vector<bool>> walls;
+    std::vector<std::pair<Node, Node>> queries;
+
+    static FuzzCase generate(uint64_t seed);
+};
+
+// What the finders get to work with; built once per case. Odd seeds use the
+// tiled layout so both index orders of the kernels are exercised.
+struct FuzzMap {
+    const std::vector<std::vector<bool>>& walls;
+    Grid grid;
+    std::shared_ptr<const DeadEndIndex> deadEnds;
+
+    explicit FuzzMap(const FuzzCase& fuzzCase);
+};
+
+// What a finder promises, and so how its result is checked against the
+// reference Dijkstra. Every finder must agree on whether a path exists, and
+// every path must be a valid 8-connected walk without corner cutting.
+enum class FuzzExpectation {
+    Optimal,      // Cost equal to the reference
+    Bounded,      // Cost at most bound * reference, lower bound at most the reference
+    FewestMoves,  // As few steps as a breadth-first search (costs ignored)
+    AnyAngle,     // Euclidean cost between the straight line and the reference
+    AnyPath,      // Valid path, no cost guarantee (Greedy)
+    OptimalCost   // Only a cost, equal to the reference; no path to check
+};
+
+struct FuzzFinder {
+    std::string name;
+    FuzzExpectation expectation;
+    double bound = 1.0;  // Bounded only
+    std::function<SearchResult(const FuzzMap& map, const Node& start, const Node& end)> run;
+};
+
+struct FuzzFailure {
+    uint64_t seed;
+    std::string finder;
+    Node start;
+    Node end;
+    std::string problem;
+};
+
+// Totals per finder, next to what the reference Dijkstra needed for the same
+// queries.
+struct FuzzFinderStats {
+    std::string name;
+    size_t queries = 0;
+    size_t failures = 0;
+    size_t nodesExpanded = 0;
+    size_t referenceExpanded = 0;
+    double timeMs = 0.0;
+    double referenceMs = 0.0;
+};
+
+// Differential testing of the path finders: every finder runs every query of
+// a case and its answer is checked against a plain reference Dijkstra (and a
+// plain breadth-first search for fewest moves) written independently of the
+// search kernels, so a kernel bug cannot hide by also being in the reference.
+// The queries' end points also make up a multi-agent task for
+// CooperativePathFinder, whose plans are checked for collisions, and each
+// case runs the stages that check files and map updates (see Stage). Their
+// totals follow the finders' in stats(), one check per query.
+class DifferentialFuzzer {
+public:
+    explicit DifferentialFuzzer(std::vector<FuzzFinder> finders = defaultFinders());
+
+    // Every finder of the app and the service, and their configurations.
+    static std::vector<FuzzFinder> defaultFinders();
+
+    // Runs one case and returns what went wrong, adding to the totals.
+    std::vector<FuzzFailure> runCase(const FuzzCase& fuzzCase);
+
+    const std::vector<FuzzFinderStats>& stats() const { return finderStats; }
+
+    // Also appends every query's result, and the reference Dijkstra's, to
+    // writer (nullptr stops recording). Seeds fix the queries, so runs of
+    // two builds over the same seeds compare query by query.
+    void recordTo(StatsWriter* writer) { recorder = writer; }
+
+    // Why path is not a valid cell-by-cell path from start to end, if it is not.
+    static std::optional<std::string> checkPath(
+        const std::vector<std::vector<bool>>& walls,
+        const Node& start,
+        const Node& end,
+        const std::vector<Node>& path
+    );
+
+    // Why cooperative plans are invalid, if they are: a plan that is not a
+    // walk of moves and waits from start to goal, or two agents on one cell
+    // at the same step or swapping cells. Agents without a plan stand on
+    // their start and planned agents stay on their goal.
+    static std::optional<std::string> checkPlans(
+        const std::vector<std::vector<bool>>& walls,
+        const std::vector<AgentTask>& agents,
+        const std::vector<SearchResult>& plans
+    );
+
+private:
+    // Checks after the finders, with their totals in this order. Each returns
+    // what went wrong, if anything.
+    enum Stage : size_t {
+        CooperativeStage,  // See runAgents
+        StatsFileStage,    // A stats file torn by a crash, then appended to
+        MapEditsStage,     // Batches of wall edits and the indexes updated for them
+        EventLogStage      // A search's event log saved, loaded and damaged
+    };
+
+    std::vector<FuzzFinder> finders;
+    std::vector<FuzzFinderStats> finderStats;
+    StatsWriter* recorder = nullptr;
+
+    FuzzFinderStats& stageStats(Stage stage) { return finderStats[finders.size() + stage]; }
+    // Times check, counts queries checks and catches what it throws.
+    std::optional<FuzzFailure> runStage(Stage stage, const FuzzCase& fuzzCase, size_t queries,
+        const std::function<std::optional<std::string>()>& check);
+
+    std::optional<std::string> checkResult(
+        const FuzzFinder& finder,
+        const FuzzMap& map,
+        const Node& start,
+        const Node& end,
+        const SearchResult& result,
+        int referenceCost,
+        int referenceMoves
+    ) const;
+    std::optional<FuzzFailure> runAgents(const FuzzCase& fuzzCase, const FuzzMap& map);
+};
\ No newline at end of file
@@ -1,37 +1,28 @@
 // DijkstrasPathFinder.h
 #pragma once
-#include "framework.h"
-#include "Constants.h"
+#include "Node.h"
+#include "BestFirstSearch.h"
+#include "CellBitset.h"
 #include <vector>
-#include <queue>
-#include <map>
-#include <set>
 
-struct Node {
-    int x, y;
-    bool operator==(const Node& other) const {
-        return x == other.x && y == other.y;
-    }
-    bool operator<(const Node& other) const {
-        return x < other.x || (x == other.x && y < other.y);
-    }
+// Dijkstra is the shared kernel with a zero heuristic.
+struct DijkstraSearchConfig : DefaultSearchConfig {
+    using Heuristic = ZeroHeuristic;
 };
 
 class DijkstrasPathFinder {
 public:
-    static std::pair<std::vector<Node>, std::set<Node>> findPath(
+    static std::pair<std::vector<Node>, CellBitset> findPath(
         const std::vector<std::vector<bool>>& walls,
         const Node& start,
         const Node& end
     );
 
-private:
-    static std::vector<std::pair<Node, int>> getNeighbors(
-        const Node& node,
-        const std::vector<std::vector<bool>>& walls
-    );
-    static std::vector<Node> reconstructPath(
-        const std::map<Node, Node>& cameFrom,
-        Node current
+    // Full result on a prebuilt grid; control (optional) cancels and streams progress.
+    static SearchResult search(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        SearchControl* control = nullptr
     );
-};
\ No newline at end of file
+};
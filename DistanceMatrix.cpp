@@ -0,0 +1,197 @@
+// DistanceMatrix.cpp
+#include "DistanceMatrix.h"
+#include "SearchPolicies.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <thread>
+#include <utility>
+
+namespace {
+    const int INFINITE_COST = (std::numeric_limits<int>::max)();
+
+    // Reused by one thread across its sweeps so the per-cell arrays are
+    // allocated once rather than per sweep.
+    class DijkstraSweep {
+    public:
+        DijkstraSweep(const Grid& grid, size_t memoryLimit)
+            : grid(grid), distance(grid.cellCount(), INFINITE_COST), targetSlot(grid.cellCount(), 0), meter(memoryLimit) {
+            meter.update(0, fixedBytes(grid), 0);
+        }
+
+        // The per-cell arrays, allocated once per thread.
+        static size_t fixedBytes(const Grid& grid) {
+            return grid.cellCount() * (sizeof(int) + sizeof(uint8_t));
+        }
+
+        const MemoryUsage& memory() const { return meter.result(); }
+
+        // Distances from origin to each cell in others, written to
+        // out[i * stride]. Stops once every reachable one has been settled,
+        // or early with Cancelled or MemoryLimit.
+        SearchStatus run(const Node& origin, const std::vector<Node>& others, int* out, size_t stride, SearchControl* control) {
+            SearchStatus status = SearchStatus::Found;
+            size_t remaining = 0;
+            for (size_t i = 0; i < others.size(); i++) {
+                out[i * stride] = DistanceMatrix::UNREACHABLE;
+                if (!grid.isWalkable(others[i].x, others[i].y)) continue;
+                uint8_t& slot = targetSlot[grid.index(others[i])];
+                if (slot == 0) remaining++;
+                slot = 1;  // Several entries may share a cell; all are filled below
+            }
+
+            if (grid.isWalkable(origin.x, origin.y) && remaining > 0) {
+                uint32_t originIndex = static_cast<uint32_t>(grid.index(origin));
+                setDistance(originIndex, 0);
+                openSet.push({ 0, originIndex });
+
+                while (!openSet.empty() && remaining > 0) {
+                    auto [cost, index] = openSet.top();
+                    openSet.pop();
+                    if (cost > distance[index]) continue;  // Stale duplicate
+                    if (control && control->isCancelled()) {
+                        status = SearchStatus::Cancelled;
+                        break;
+                    }
+
+                    if (targetSlot[index] == 1) {
+                        targetSlot[index] = 2;  // Settled
+                        remaining--;
+                    }
+
+                    Node current = grid.node(index);
+                    EightConnected::forEachNeighbor(grid, current.x, current.y, [&](int x, int y, int step) {
+                        uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+                        if (cost + step < distance[neighbor]) {
+                            setDistance(neighbor, cost + step);
+                            openSet.push({ cost + step, neighbor });
+                        }
+                    });
+
+                    if (!meter.update(openSet.size() * sizeof(Entry), fixedBytes(grid) + touched.size() * sizeof(uint32_t), 0)) {
+                        status = SearchStatus::MemoryLimit;
+                        break;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < others.size(); i++) {
+                if (!grid.isWalkable(others[i].x, others[i].y)) continue;
+                size_t cell = grid.index(others[i]);
+                if (targetSlot[cell] == 2) {
+                    out[i * stride] = distance[cell];
+                }
+            }
+            reset(others);
+            return status;
+        }
+
+    private:
+        using Entry = std::pair<int, uint32_t>;
+
+        const Grid& grid;
+        std::vector<int> distance;
+        std::vector<uint8_t> targetSlot;  // 0: not a target, 1: unsettled target, 2: settled target
+        std::vector<uint32_t> touched;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openSet;
+        MemoryMeter meter;
+
+        void setDistance(uint32_t index, int cost) {
+            if (distance[index] == INFINITE_COST) touched.push_back(index);
+            distance[index] = cost;
+        }
+
+        // Clears only the cells this sweep wrote to
+        void reset(const std::vector<Node>& others) {
+            for (uint32_t index : touched) {
+                distance[index] = INFINITE_COST;
+            }
+            touched.clear();
+            for (const Node& other : others) {
+                if (grid.inBounds(other.x, other.y)) {
+                    targetSlot[grid.index(other)] = 0;
+                }
+            }
+            openSet = {};
+        }
+    };
+}
+
+DistanceMatrix DistanceMatrix::compute(
+    const Grid& grid,
+    const std::vector<Node>& sources,
+    const std::vector<Node>& targets,
+    size_t threadCount,
+    SearchControl* control
+) {
+    DistanceMatrix matrix;
+    matrix.rowCount = sources.size();
+    matrix.columnCount = targets.size();
+    matrix.costs.assign(sources.size() * targets.size(), UNREACHABLE);
+    if (matrix.costs.empty()) {
+        return matrix;
+    }
+
+    // Sweep from whichever side is smaller
+    const bool bySource = sources.size() <= targets.size();
+    const std::vector<Node>& origins = bySource ? sources : targets;
+    const std::vector<Node>& others = bySource ? targets : sources;
+
+    if (threadCount == 0) {
+        threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = (std::min)(threadCount, origins.size());
+
+    const size_t memoryLimit = control ? control->memoryLimit() : MemoryMeter::UNLIMITED;
+    const size_t sweepBytes = DijkstraSweep::fixedBytes(grid);
+    while (threadCount > 1 && memoryLimit / threadCount < sweepBytes) {
+        threadCount--;
+    }
+    if (memoryLimit < sweepBytes) {
+        matrix.searchStatus = SearchStatus::MemoryLimit;
+        return matrix;
+    }
+
+    std::atomic<size_t> nextOrigin{ 0 };
+    std::atomic<SearchStatus> stopped{ SearchStatus::Found };
+    std::vector<MemoryUsage> threadUsage(threadCount);
+    auto worker = [&](size_t thread) {
+        DijkstraSweep sweep(grid, memoryLimit / threadCount);
+        for (size_t i = nextOrigin++; i < origins.size() && stopped == SearchStatus::Found; i = nextOrigin++) {
+            int* out = bySource
+                ? &matrix.costs[i * matrix.columnCount]  // Row i
+                : &matrix.costs[i];                       // Column i
+            SearchStatus status = sweep.run(origins[i], others, out, bySource ? 1 : matrix.columnCount, control);
+            if (status != SearchStatus::Found) {
+                stopped = status;
+            }
+        }
+        threadUsage[thread] = sweep.memory();
+    };
+
+    if (threadCount <= 1) {
+        worker(0);
+    }
+    else {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threadCount; t++) {
+            workers.emplace_back(worker, t);
+        }
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+    }
+
+    matrix.searchStatus = stopped;
+    for (const MemoryUsage& used : threadUsage) {
+        matrix.usage.openList += used.openList;
+        matrix.usage.scores += used.scores;
+        matrix.usage.explored += used.explored;
+        matrix.usage.peakBytes += used.peakBytes;
+    }
+    matrix.usage.path = matrix.costs.size() * sizeof(int);
+    matrix.usage.peakBytes += matrix.usage.path;
+    return matrix;
+}
@@ -0,0 +1,57 @@
+// DistanceMatrix.h
+#pragma once
+#include "Grid.h"
+#include "Node.h"
+#include "BestFirstSearch.h"
+#include "SearchControl.h"
+#include <vector>
+#include <cstddef>
+
+// Optimal path costs between every source and every target on one grid (e.g.
+// agents x tasks for an assignment solver), stored as a dense row-major
+// sources x targets buffer of ints.
+//
+// Instead of one A* per pair it runs one Dijkstra sweep per cell on the
+// smaller side. Each sweep stops once it has settled every cell on the
+// other side. Movement costs are symmetric (EightConnected, 10/14), so a
+// sweep from a target fills a whole column just as a sweep from a source
+// fills a row. Sweeps are spread over threads; each writes only its own
+// row or column.
+//
+// A control can cancel the sweeps and cap their memory; it gets no progress,
+// since several threads expand at once. Each thread's sweep gets an equal
+// share of the cap (fewer threads are used if a share cannot hold the
+// per-cell arrays), and memory() sums the threads' peaks. The matrix itself
+// counts as the path: it is the output, so it never fails the cap.
+class DistanceMatrix {
+public:
+    static constexpr int UNREACHABLE = -1;
+
+    static DistanceMatrix compute(
+        const Grid& grid,
+        const std::vector<Node>& sources,
+        const std::vector<Node>& targets,
+        size_t threadCount = 0,
+        SearchControl* control = nullptr
+    );
+
+    // Found once every sweep has run; Cancelled or MemoryLimit if one was
+    // stopped, in which case the costs it did not settle are UNREACHABLE.
+    SearchStatus status() const { return searchStatus; }
+    const MemoryUsage& memory() const { return usage; }
+
+    size_t rows() const { return rowCount; }
+    size_t columns() const { return columnCount; }
+    int at(size_t source, size_t target) const { return costs[source * columnCount + target]; }
+
+    // rows() * columns() costs, row by row; UNREACHABLE where there is no path.
+    const std::vector<int>& buffer() const { return costs; }
+    std::vector<int> releaseBuffer() { return std::move(costs); }
+
+private:
+    size_t rowCount = 0;
+    size_t columnCount = 0;
+    std::vector<int> costs;
+    SearchStatus searchStatus = SearchStatus::Found;
+    MemoryUsage usage;
+};
@@ -1,28 +1,30 @@
 // GreedyPathFinder.h
 #pragma once
-#include "framework.h"
-#include "Constants.h"
-#include "DijkstrasPathFinder.h"
+#include "Node.h"
+#include "BestFirstSearch.h"
+#include "CellBitset.h"
 #include <vector>
-#include <map>
-#include <set>
+
+// Greedy best-first orders the open list by heuristic alone and reports every
+// generated node as explored.
+struct GreedySearchConfig : DefaultSearchConfig {
+    using Recorder = RecordGenerated;
+    using Scoring = GreedyScoring;
+};
 
 class GreedyPathFinder {
 public:
-    static std::pair<std::vector<Node>, std::set<Node>> findPath(
+    static std::pair<std::vector<Node>, CellBitset> findPath(
         const std::vector<std::vector<bool>>& walls,
         const Node& start,
         const Node& end
     );
 
-private:
-    static int calculateHeuristic(const Node& a, const Node& b);
-    static std::vector<std::pair<Node, int>> getNeighbors(
-        const Node& node,
-        const std::vector<std::vector<bool>>& walls
-    );
-    static std::vector<Node> reconstructPath(
-        const std::map<Node, Node>& cameFrom,
-        Node current
+    // Full result on a prebuilt grid; control (optional) cancels and streams progress.
+    static SearchResult search(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        SearchControl* control = nullptr
     );
-};
\ No newline at end of file
+};
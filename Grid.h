@@ -0,0 +1,125 @@
+// Grid.h
+#pragma once
+#include "Node.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// How cells map to indices. Row-major suits narrow grids; on wide grids a
+// vertical or diagonal step is a whole row away and lands on a new cache line
+// almost every time, so 8x8 tiles keep each cell's neighbourhood within a few
+// lines (a tile of uint8_t walls is exactly 64 bytes).
+enum class CellLayout {
+    RowMajor,  // index = y * width + x
+    Tiled8x8   // 8x8 tiles stored one after another, row-major within and between tiles
+};
+
+// Flat copy of the wall layout. The search kernels address cells by index so
+// that their per-cell state can live in plain vectors instead of maps; the
+// layout decides the index order and is invisible outside this class.
+class Grid {
+public:
+    Grid(int width, int height, CellLayout layout = CellLayout::RowMajor)
+        : gridWidth(width),
+        gridHeight(height),
+        cellLayout(layout),
+        tilesPerRow((width + 7) / 8),
+        blocked(layout == CellLayout::RowMajor
+            ? static_cast<size_t>(width) * height
+            : static_cast<size_t>(tilesPerRow) * ((height + 7) / 8) * 64,
+            layout == CellLayout::RowMajor ? 0 : 1) {
+        if (layout != CellLayout::RowMajor) {
+            // Tile padding past the right and bottom edges stays blocked
+            for (int y = 0; y < gridHeight; y++) {
+                for (int x = 0; x < gridWidth; x++) {
+                    blocked[index(x, y)] = 0;
+                }
+            }
+        }
+    }
+
+    explicit Grid(const std::vector<std::vector<bool>>& walls, CellLayout layout = CellLayout::RowMajor)
+        : Grid(walls.empty() ? 0 : static_cast<int>(walls[0].size()), static_cast<int>(walls.size()), layout) {
+        for (int y = 0; y < gridHeight; y++) {
+            for (int x = 0; x < gridWidth; x++) {
+                blocked[index(x, y)] = walls[y][x] ? WALL : 0;
+            }
+        }
+    }
+
+    // Tiles once a row of walls no longer fits in a few cache lines.
+    static CellLayout preferredLayout(int width) {
+        return width >= 512 ? CellLayout::Tiled8x8 : CellLayout::RowMajor;
+    }
+
+    // Nested-vector form for finders that still take walls directly (JPS).
+    std::vector<std::vector<bool>> toWalls() const {
+        std::vector<std::vector<bool>> walls(gridHeight, std::vector<bool>(gridWidth, false));
+        for (int y = 0; y < gridHeight; y++) {
+            for (int x = 0; x < gridWidth; x++) {
+                walls[y][x] = blocked[index(x, y)] == WALL;
+            }
+        }
+        return walls;
+    }
+
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+    CellLayout layout() const { return cellLayout; }
+    // Size of the index space, for sizing per-cell arrays. With tiling this
+    // includes padding cells, which are never walkable.
+    size_t cellCount() const { return blocked.size(); }
+
+    size_t index(int x, int y) const {
+        if (cellLayout == CellLayout::RowMajor) {
+            return static_cast<size_t>(y) * gridWidth + x;
+        }
+        size_t tile = static_cast<size_t>(y >> 3) * tilesPerRow + (x >> 3);
+        return (tile << 6) | (static_cast<size_t>(y & 7) << 3) | static_cast<size_t>(x & 7);
+    }
+    size_t index(const Node& node) const { return index(node.x, node.y); }
+    Node node(size_t index) const {
+        if (cellLayout == CellLayout::RowMajor) {
+            return Node{ static_cast<int>(index % gridWidth), static_cast<int>(index / gridWidth) };
+        }
+        size_t tile = index >> 6;
+        int within = static_cast<int>(index & 63);
+        return Node{
+            static_cast<int>(tile % tilesPerRow) * 8 + (within & 7),
+            static_cast<int>(tile / tilesPerRow) * 8 + (within >> 3)
+        };
+    }
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < gridWidth && y >= 0 && y < gridHeight;
+    }
+    bool isWalkable(int x, int y) const {
+        return inBounds(x, y) && blocked[index(x, y)] != WALL;
+    }
+    // Walkable and not excluded: a cell the GridMovement searches may step onto.
+    bool isEnterable(int x, int y) const {
+        return inBounds(x, y) && blocked[index(x, y)] == 0;
+    }
+    void setWall(int x, int y, bool state) {
+        if (inBounds(x, y)) {
+            blocked[index(x, y)] = state ? WALL : 0;
+        }
+    }
+    // Keeps a walkable cell out of the searches while it still counts as free
+    // for the corner-cutting rule (see DeadEndIndex). setWall undoes it.
+    void exclude(int x, int y) {
+        if (isWalkable(x, y)) {
+            blocked[index(x, y)] = EXCLUDED;
+        }
+    }
+
+private:
+    static constexpr uint8_t WALL = 1;
+    static constexpr uint8_t EXCLUDED = 2;
+
+    int gridWidth;
+    int gridHeight;
+    CellLayout cellLayout;
+    int tilesPerRow;
+    std::vector<uint8_t> blocked;  // 0, WALL or EXCLUDED
+};
\ No newline at end of file
@@ -0,0 +1,107 @@
+// GridRenderer.cpp
+#include "GridRenderer.h"
+#include <algorithm>
+
+namespace {
+    const uint32_t BACKGROUND_COLOR = PixelBuffer::rgb(255, 255, 255);
+    const uint32_t EXPLORED_COLOR = PixelBuffer::rgb(255, 255, 200);
+    const uint32_t WALL_COLOR = PixelBuffer::rgb(0, 0, 0);
+    const uint32_t PATH_COLOR = PixelBuffer::rgb(0, 0, 255);
+    const uint32_t START_COLOR = PixelBuffer::rgb(0, 255, 0);
+    const uint32_t END_COLOR = PixelBuffer::rgb(255, 0, 0);
+    const uint32_t TARGET_COLOR = PixelBuffer::rgb(255, 140, 0);
+    const uint32_t GRID_LINE_COLOR = PixelBuffer::rgb(200, 200, 200);
+}
+
+GridRenderer::GridRenderer(int gridWidth, int gridHeight, int cellSize)
+    : gridWidth(gridWidth),
+    gridHeight(gridHeight),
+    cellSize(cellSize),
+    cells(static_cast<size_t>(gridWidth) * gridHeight, 0),
+    frame(gridWidth * cellSize, gridHeight * cellSize, BACKGROUND_COLOR) {
+    for (int y = 0; y < gridHeight; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            paintCell(x, y);
+        }
+    }
+}
+
+void GridRenderer::setWall(int x, int y, bool state) {
+    setFlag(x, y, WALL, state);
+}
+
+void GridRenderer::setExplored(int x, int y, bool state) {
+    setFlag(x, y, EXPLORED, state);
+}
+
+void GridRenderer::setPath(int x, int y, bool state) {
+    setFlag(x, y, PATH, state);
+}
+
+void GridRenderer::setTarget(int x, int y, bool state) {
+    setFlag(x, y, TARGET, state);
+}
+
+void GridRenderer::setStart(std::optional<Node> node) {
+    std::optional<Node> previous = startPoint;
+    startPoint = node;
+    if (previous) paintCell(previous->x, previous->y);
+    if (node) paintCell(node->x, node->y);
+}
+
+void GridRenderer::setEnd(std::optional<Node> node) {
+    std::optional<Node> previous = endPoint;
+    endPoint = node;
+    if (previous) paintCell(previous->x, previous->y);
+    if (node) paintCell(node->x, node->y);
+}
+
+std::optional<PixelRect> GridRenderer::takeDirtyRect() {
+    if (dirty.empty()) {
+        return std::nullopt;
+    }
+    PixelRect rect = dirty;
+    dirty = PixelRect{ 0, 0, 0, 0 };
+    return rect;
+}
+
+void GridRenderer::setFlag(int x, int y, uint8_t flag, bool state) {
+    if (x < 0 || x >= gridWidth || y < 0 || y >= gridHeight) return;
+
+    uint8_t& cell = cells[static_cast<size_t>(y) * gridWidth + x];
+    uint8_t updated = state ? (cell | flag) : (cell & ~flag);
+    if (updated != cell) {
+        cell = updated;
+        paintCell(x, y);
+    }
+}
+
+// Same precedence as the old GDI painter: end, start, (target,) path, wall, explored.
+// The top and left pixel lines of each cell are the grid lines.
+void GridRenderer::paintCell(int x, int y) {
+    uint8_t cell = cells[static_cast<size_t>(y) * gridWidth + x];
+    Node node{ x, y };
+
+    uint32_t color = BACKGROUND_COLOR;
+    if (endPoint && *endPoint == node) color = END_COLOR;
+    else if (startPoint && *startPoint == node) color = START_COLOR;
+    else if (cell & TARGET) color = TARGET_COLOR;
+    else if (cell & PATH) color = PATH_COLOR;
+    else if (cell & WALL) color = WALL_COLOR;
+    else if (cell & EXPLORED) color = EXPLORED_COLOR;
+
+    PixelRect rect{ x * cellSize, y * cellSize, (x + 1) * cellSize, (y + 1) * cellSize };
+    frame.fillRect(rect, color);
+    frame.fillRect(PixelRect{ rect.left, rect.top, rect.right, rect.top + 1 }, GRID_LINE_COLOR);
+    frame.fillRect(PixelRect{ rect.left, rect.top, rect.left + 1, rect.bottom }, GRID_LINE_COLOR);
+
+    if (dirty.empty()) {
+        dirty = rect;
+    }
+    else {
+        dirty.left = (std::min)(dirty.left, rect.left);
+        dirty.top = (std::min)(dirty.top, rect.top);
+        dirty.right = (std::max)(dirty.right, rect.right);
+        dirty.bottom = (std::max)(dirty.bottom, rect.bottom);
+    }
+}
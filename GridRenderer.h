@@ -0,0 +1,48 @@
+// GridRenderer.h
+#pragma once
+#include "Node.h"
+#include "PixelBuffer.h"
+#include <vector>
+#include <optional>
+#include <cstdint>
+
+// Keeps a pixel image of the grid up to date cell by cell. Every change repaints
+// only the affected cell and grows a dirty rectangle, which the window then
+// invalidates and blits instead of redrawing everything. Has no Windows
+// dependency, so it can also render snapshots headlessly.
+class GridRenderer {
+public:
+    GridRenderer(int gridWidth, int gridHeight, int cellSize);
+
+    void setWall(int x, int y, bool state);
+    void setExplored(int x, int y, bool state);
+    void setPath(int x, int y, bool state);
+    void setTarget(int x, int y, bool state);
+    void setStart(std::optional<Node> node);
+    void setEnd(std::optional<Node> node);
+
+    const PixelBuffer& pixels() const { return frame; }
+
+    // Pixel area changed since the last call, if any.
+    std::optional<PixelRect> takeDirtyRect();
+
+private:
+    enum CellFlags : uint8_t {
+        WALL = 1 << 0,
+        EXPLORED = 1 << 1,
+        PATH = 1 << 2,
+        TARGET = 1 << 3
+    };
+
+    int gridWidth;
+    int gridHeight;
+    int cellSize;
+    std::vector<uint8_t> cells;
+    std::optional<Node> startPoint;
+    std::optional<Node> endPoint;
+    PixelBuffer frame;
+    PixelRect dirty{ 0, 0, 0, 0 };
+
+    void setFlag(int x, int y, uint8_t flag, bool state);
+    void paintCell(int x, int y);
+};
@@ -0,0 +1,103 @@
+// GridSnapshot.cpp
+#include "GridSnapshot.h"
+#include <bit>
+
+GridSnapshot::GridSnapshot(const std::vector<std::vector<bool>>& walls)
+    : gridWidth(walls.empty() ? 0 : static_cast<int>(walls[0].size())),
+    gridHeight(static_cast<int>(walls.size())),
+    tilesPerRow((gridWidth + TILE_SIZE - 1) / TILE_SIZE) {
+    int tilesPerColumn = (gridHeight + TILE_SIZE - 1) / TILE_SIZE;
+    tiles.reserve(static_cast<size_t>(tilesPerRow) * tilesPerColumn);
+    for (int tileY = 0; tileY < tilesPerColumn; tileY++) {
+        for (int tileX = 0; tileX < tilesPerRow; tileX++) {
+            auto tile = std::make_shared<Tile>();
+            tile->fill(0);
+            for (int y = 0; y < TILE_SIZE && tileY * TILE_SIZE + y < gridHeight; y++) {
+                for (int x = 0; x < TILE_SIZE && tileX * TILE_SIZE + x < gridWidth; x++) {
+                    if (walls[tileY * TILE_SIZE + y][tileX * TILE_SIZE + x]) {
+                        (*tile)[y] |= uint64_t{ 1 } << x;
+                    }
+                }
+            }
+            tiles.push_back(std::move(tile));
+        }
+    }
+}
+
+// Shares every tile of previous; the caller replaces the ones it edits.
+GridSnapshot::GridSnapshot(const GridSnapshot& previous, uint64_t version)
+    : gridWidth(previous.gridWidth),
+    gridHeight(previous.gridHeight),
+    tilesPerRow(previous.tilesPerRow),
+    mapVersion(version),
+    tiles(previous.tiles) {
+}
+
+bool GridSnapshot::isWall(int x, int y) const {
+    if (x < 0 || x >= gridWidth || y < 0 || y >= gridHeight) {
+        return false;
+    }
+    return ((*tiles[tileIndex(x, y)])[y % TILE_SIZE] >> (x % TILE_SIZE)) & 1;
+}
+
+std::vector<std::vector<bool>> GridSnapshot::toWalls() const {
+    std::vector<std::vector<bool>> walls(gridHeight, std::vector<bool>(gridWidth, false));
+    for (int y = 0; y < gridHeight; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            walls[y][x] = isWall(x, y);
+        }
+    }
+    return walls;
+}
+
+std::shared_ptr<const GridSnapshot> GridSnapshot::withEdits(const std::vector<CellEdit>& edits) const {
+    // Private constructor, so no make_shared
+    std::shared_ptr<GridSnapshot> next(new GridSnapshot(*this, mapVersion + 1));
+
+    // Copy each touched tile once; later edits in the same tile write the copy
+    std::vector<Tile*> copied(tiles.size(), nullptr);
+    for (const CellEdit& edit : edits) {
+        if (edit.x < 0 || edit.x >= gridWidth || edit.y < 0 || edit.y >= gridHeight) {
+            continue;
+        }
+
+        size_t index = tileIndex(edit.x, edit.y);
+        if (!copied[index]) {
+            auto tile = std::make_shared<Tile>(*tiles[index]);
+            copied[index] = tile.get();
+            next->tiles[index] = std::move(tile);
+        }
+        uint64_t bit = uint64_t{ 1 } << (edit.x % TILE_SIZE);
+        uint64_t& row = (*copied[index])[edit.y % TILE_SIZE];
+        row = edit.wall ? (row | bit) : (row & ~bit);
+    }
+    return next;
+}
+
+std::shared_ptr<const Grid> GridSnapshot::grid() const {
+    std::call_once(flattenOnce, [this] {
+        auto grid = std::make_shared<Grid>(gridWidth, gridHeight, Grid::preferredLayout(gridWidth));
+        for (size_t index = 0; index < tiles.size(); index++) {
+            int baseX = static_cast<int>(index % tilesPerRow) * TILE_SIZE;
+            int baseY = static_cast<int>(index / tilesPerRow) * TILE_SIZE;
+            const Tile& tile = *tiles[index];
+            for (int y = 0; y < TILE_SIZE; y++) {
+                for (uint64_t rest = tile[y]; rest; rest &= rest - 1) {
+                    grid->setWall(baseX + std::countr_zero(rest), baseY + y, true);
+                }
+            }
+        }
+        flat = std::move(grid);
+    });
+    return flat;
+}
+
+size_t GridSnapshot::sharedTiles(const GridSnapshot& other) const {
+    size_t shared = 0;
+    for (size_t i = 0; i < tiles.size() && i < other.tiles.size(); i++) {
+        if (tiles[i] == other.tiles[i]) {
+            shared++;
+        }
+    }
+    return shared;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// GridSnapshot.h
+#pragma once
+#include "Grid.h"
+#include "MapEdit.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Immutable version of the walls, stored as 64x64-cell tiles of wall bits
+// (one 64-bit word per tile row) held by shared_ptr. withEdits() copies only
+// the tiles an edit touches and shares every other tile with the version it
+// came from, so a new version costs a few hundred bytes per touched tile
+// rather than a copy of the map.
+//
+// Searches read a flat Grid, which grid() builds on first use and then hands
+// to every search of the same version.
+class GridSnapshot {
+public:
+    static constexpr int TILE_SIZE = 64;
+
+    explicit GridSnapshot(const std::vector<std::vector<bool>>& walls);
+
+    uint64_t version() const { return mapVersion; }
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+    bool isWall(int x, int y) const;
+    std::vector<std::vector<bool>> toWalls() const;
+
+    // The next version with edits applied; this snapshot is unchanged.
+    std::shared_ptr<const GridSnapshot> withEdits(const std::vector<CellEdit>& edits) const;
+
+    // Flat copy for the search kernels, built once per version (thread-safe).
+    std::shared_ptr<const Grid> grid() const;
+
+    size_t tileCount() const { return tiles.size(); }
+    // Tiles shared with another version of the same map.
+    size_t sharedTiles(const GridSnapshot& other) const;
+
+private:
+    using Tile = std::array<uint64_t, TILE_SIZE>;  // Bit x of word y: cell (x, y) of the tile is a wall
+
+    int gridWidth;
+    int gridHeight;
+    int tilesPerRow;
+    uint64_t mapVersion = 0;
+    std::vector<std::shared_ptr<const Tile>> tiles;
+    mutable std::once_flag flattenOnce;
+    mutable std::shared_ptr<const Grid> flat;
+
+    GridSnapshot(const GridSnapshot& previous, uint64_t version);
+    size_t tileIndex(int x, int y) const {
+        return static_cast<size_t>(y / TILE_SIZE) * tilesPerRow + x / TILE_SIZE;
+    }
+};
+
+// Publishes snapshots RCU-style: readers take the current version with one
+// atomic load and may keep it as long as they like, without locks; the writer
+// builds the next version beside it and swaps it in with one atomic store. A
+// version is freed when its last reader (e.g. a background search) lets go.
+// One writer at a time.
+class VersionedGrid {
+public:
+    explicit VersionedGrid(const std::vector<std::vector<bool>>& walls)
+        : published(std::make_shared<const GridSnapshot>(walls)) {
+    }
+
+    std::shared_ptr<const GridSnapshot> current() const {
+        return published.load(std::memory_order_acquire);
+    }
+
+    // Writer only. Returns the version it published.
+    std::shared_ptr<const GridSnapshot> publish(const std::vector<CellEdit>& edits) {
+        std::shared_ptr<const GridSnapshot> next = current()->withEdits(edits);
+        published.store(next, std::memory_order_release);
+        return next;
+    }
+
+private:
+    std::atomic<std::shared_ptr<const GridSnapshot>> published;
+};
\ No newline at end of file
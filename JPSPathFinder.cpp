@@ -5,7 +5,7 @@
 #include <algorithm>
 
 bool JPSPathFinder::isWalkable(const std::vector<std::vector<bool>>& walls, int x, int y) {
-    return x >= 0 && x < Constants::GRID_WIDTH && y >= 0 && y < Constants::GRID_HEIGHT && !walls[y][x];
+    return y >= 0 && y < static_cast<int>(walls.size()) && x >= 0 && x < static_cast<int>(walls[y].size()) && !walls[y][x];
 }
 
 bool JPSPathFinder::validDiagonalMove(const std::vector<std::vector<bool>>& walls, int x, int y, const Direction& dir) {
@@ -14,40 +14,42 @@ bool JPSPathFinder::validDiagonalMove(const std::vector<std::vector<bool>>& wall
         isWalkable(walls, x, y + dir.dy);
 }
 
+// Movement never cuts corners, so a diagonal step has no forced neighbours
+// (the straight jumps it spawns find every turn), and a straight one has one
+// where a side cell opens up that could not be reached diagonally from the
+// previous cell because the cell behind it is blocked.
 bool JPSPathFinder::hasForced(const std::vector<std::vector<bool>>& walls, int x, int y, const Direction& dir) {
     if (dir.isDiagonal()) {
-        return (!isWalkable(walls, x + dir.dx, y) && isWalkable(walls, x + dir.dx, y + dir.dy)) ||
-            (!isWalkable(walls, x, y + dir.dy) && isWalkable(walls, x + dir.dx, y + dir.dy));
+        return false;
     }
     if (dir.dx != 0) {
-        return (!isWalkable(walls, x, y + 1) && isWalkable(walls, x + dir.dx, y + 1)) ||
-            (!isWalkable(walls, x, y - 1) && isWalkable(walls, x + dir.dx, y - 1));
+        return (isWalkable(walls, x, y + 1) && !isWalkable(walls, x - dir.dx, y + 1)) ||
+            (isWalkable(walls, x, y - 1) && !isWalkable(walls, x - dir.dx, y - 1));
     }
-    if (dir.dy != 0) {
-        return (!isWalkable(walls, x + 1, y) && isWalkable(walls, x + 1, y + dir.dy)) ||
-            (!isWalkable(walls, x - 1, y) && isWalkable(walls, x - 1, y + dir.dy));
-    }
-    return false;
+    return (isWalkable(walls, x + 1, y) && !isWalkable(walls, x + 1, y - dir.dy)) ||
+        (isWalkable(walls, x - 1, y) && !isWalkable(walls, x - 1, y - dir.dy));
 }
 
+// Iterative along dir; only a diagonal jump recurses, one level, into the two
+// straight jumps it spawns at every cell.
 std::optional<Node> JPSPathFinder::jump(const std::vector<std::vector<bool>>& walls,
     int x, int y, const Direction& dir, const Node& end) {
-    int nextX = x + dir.dx;
-    int nextY = y + dir.dy;
-
-    if (!isWalkable(walls, nextX, nextY)) return std::nullopt;
-    if (dir.isDiagonal() && !validDiagonalMove(walls, x, y, dir)) return std::nullopt;
-    if (Node{ nextX, nextY } == end) return Node{ nextX, nextY };
-    if (hasForced(walls, nextX, nextY, dir)) return Node{ nextX, nextY };
-
-    if (dir.isDiagonal()) {
-        if (jump(walls, nextX, nextY, Direction{ dir.dx, 0 }, end) ||
-            jump(walls, nextX, nextY, Direction{ 0, dir.dy }, end)) {
-            return Node{ nextX, nextY };
+    while (true) {
+        if (dir.isDiagonal() && !validDiagonalMove(walls, x, y, dir)) return std::nullopt;
+        x += dir.dx;
+        y += dir.dy;
+
+        if (!isWalkable(walls, x, y)) return std::nullopt;
+        if (Node{ x, y } == end) return Node{ x, y };
+        if (hasForced(walls, x, y, dir)) return Node{ x, y };
+
+        if (dir.isDiagonal()) {
+            if (jump(walls, x, y, Direction{ dir.dx, 0 }, end) ||
+                jump(walls, x, y, Direction{ 0, dir.dy }, end)) {
+                return Node{ x, y };
+            }
         }
     }
-
-    return jump(walls, nextX, nextY, dir, end);
 }
 
 std::vector<JumpPoint> JPSPathFinder::identifySuccessors(const std::vector<std::vector<bool>>& walls,
@@ -68,14 +70,10 @@ std::vector<JumpPoint> JPSPathFinder::identifySuccessors(const std::vector<std::
     return successors;
 }
 
+// Jumps run along a straight or diagonal line, so their cost is the octile
+// distance between the ends.
 int JPSPathFinder::movementCost(const Node& a, const Node& b) {
-    return (a.x != b.x && a.y != b.y) ? 14 : 10;
-}
-
-int JPSPathFinder::heuristic(const Node& a, const Node& b) {
-    int dx = std::abs(a.x - b.x);
-    int dy = std::abs(a.y - b.y);
-    return 10 * (dx + dy) + (14 - 2 * 10) * std::min(dx, dy);
+    return OctileHeuristic{}(a, b);
 }
 
 std::vector<Node> JPSPathFinder::reconstructPath(const std::map<Node, NodeScore>& nodeInfo,
@@ -99,50 +97,109 @@ std::vector<Node> JPSPathFinder::reconstructPath(const std::map<Node, NodeScore>
     return path;
 }
 
-std::pair<std::vector<Node>, std::set<Node>> JPSPathFinder::findPath(
+std::pair<std::vector<Node>, CellBitset> JPSPathFinder::findPath(
     const std::vector<std::vector<bool>>& walls,
     const Node& start,
     const Node& end) {
-    auto compare = [](const std::pair<int, NodeScore>& a, const std::pair<int, NodeScore>& b) {
+    SearchResult result = search(walls, start, end);
+    return { std::move(result.path), std::move(result.explored) };
+}
+
+SearchResult JPSPathFinder::search(
+    const std::vector<std::vector<bool>>& walls,
+    const Node& start,
+    const Node& end,
+    SearchControl* control) {
+    // Queue entries carry only f and the node; the rest of its score lives
+    // once, in nodeInfo. The first entry of a node to surface is its lowest f,
+    // pushed with the g nodeInfo still holds.
+    using QueueEntry = std::pair<int, Node>;
+    auto compare = [](const QueueEntry& a, const QueueEntry& b) {
         return a.first > b.first;
         };
 
-    std::priority_queue<std::pair<int, NodeScore>, std::vector<std::pair<int, NodeScore>>, decltype(compare)> openSet(compare);
+    const int width = walls.empty() ? 0 : static_cast<int>(walls[0].size());
+    const int height = static_cast<int>(walls.size());
+    SearchResult result;
+
+    // The closed and explored sets are the only per-cell arrays; nodeInfo and
+    // the queue grow with the jump points found
+    const size_t exploredBytes = 2 * CellBitset::bytesFor(static_cast<size_t>(width) * height);
+    MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    if (!meter.fits(0, 0, exploredBytes)) {
+        result.status = SearchStatus::MemoryLimit;
+        return result;
+    }
+    meter.update(0, 0, exploredBytes);
+
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, decltype(compare)> openSet(compare);
     std::map<Node, NodeScore> nodeInfo;
-    std::set<Node> closedSet;
-    std::set<Node> explored;
+    CellBitset closedSet(width, height);
+    CellBitset explored(width, height);
+    OctileHeuristic heuristic;
+    SearchEventLog* events = control ? control->eventLog() : nullptr;
 
     NodeScore startScore{ start, 0, heuristic(start, end), start, 0, 0 };
-    openSet.push({ startScore.f, startScore });
+    openSet.push({ startScore.f, start });
     nodeInfo[start] = startScore;
-    explored.insert(start);
+    explored.set(start);
+    if (events) events->record(SearchEventType::Push, start);
 
     while (!openSet.empty()) {
-        NodeScore current = openSet.top().second;
+        NodeScore current = nodeInfo[openSet.top().second];
         openSet.pop();
 
         if (current.node == end) {
-            return { reconstructPath(nodeInfo, walls, end), explored };
+            result.status = SearchStatus::Found;
+            result.path = reconstructPath(nodeInfo, walls, end);
+            result.cost = gridPathCost(result.path);
+            meter.addPath(result.path.size() * sizeof(Node));
+            break;
         }
 
-        if (closedSet.count(current.node)) continue;
-        closedSet.insert(current.node);
+        if (closedSet.test(current.node)) continue;
+        closedSet.set(current.node);
+        result.nodesExpanded++;
+        if (events) events->record(SearchEventType::Pop, current.node);
+
+        if (control) {
+            if (control->isCancelled()) {
+                result.status = SearchStatus::Cancelled;
+                break;
+            }
+            control->nodeExpanded(current.node);
+        }
 
         for (const auto& successor : identifySuccessors(walls, current.node, end)) {
-            if (closedSet.count(successor.node)) continue;
+            if (closedSet.test(successor.node)) continue;
 
-            explored.insert(successor.node);
+            explored.set(successor.node);
+            if (events) events->record(SearchEventType::Jump, successor.node);
             int newG = current.g + movementCost(current.node, successor.node);
             int newF = newG + heuristic(successor.node, end);
 
             auto existing = nodeInfo.find(successor.node);
             if (existing == nodeInfo.end() || newG < existing->second.g) {
+                if (events) {
+                    events->record(existing == nodeInfo.end() ? SearchEventType::Push : SearchEventType::Relax,
+                        successor.node);
+                }
                 NodeScore newScore{ successor.node, newG, newF, current.node, successor.dir.dx, successor.dir.dy };
-                openSet.push({ newF, newScore });
+                openSet.push({ newF, successor.node });
                 nodeInfo[successor.node] = newScore;
             }
         }
+
+        if (!meter.update(openSet.size() * sizeof(QueueEntry), nodeInfo.size() * NODE_INFO_ENTRY_BYTES, exploredBytes)) {
+            result.status = SearchStatus::MemoryLimit;
+            break;
+        }
     }
 
-    return { std::vector<Node>(), explored };
+    if (control) {
+        control->flush();
+    }
+    result.explored = std::move(explored);
+    result.memory = meter.result();
+    return result;
 }
\ No newline at end of file
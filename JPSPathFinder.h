@@ -1,12 +1,15 @@
 // JPSPathFinder.h
 #pragma once
-#include "framework.h"
 #include "Constants.h"
-#include "DijkstrasPathFinder.h"
+#include "Node.h"
+#include "SearchPolicies.h"
+#include "BestFirstSearch.h"
+#include "CellBitset.h"
+#include "SearchControl.h"
 #include <vector>
 #include <map>
-#include <set>
 #include <optional>
+#include <cstdlib>
 
 struct Direction {
     int dx, dy;
@@ -26,12 +29,20 @@ struct JumpPoint {
 
 class JPSPathFinder {
 public:
-    static std::pair<std::vector<Node>, std::set<Node>> findPath(
+    static std::pair<std::vector<Node>, CellBitset> findPath(
         const std::vector<std::vector<bool>>& walls,
         const Node& start,
         const Node& end
     );
 
+    // Full result; control (optional) cancels and streams progress.
+    static SearchResult search(
+        const std::vector<std::vector<bool>>& walls,
+        const Node& start,
+        const Node& end,
+        SearchControl* control = nullptr
+    );
+
 private:
     struct NodeScore {
         Node node;
@@ -41,6 +52,9 @@ private:
         int dx, dy;
     };
 
+    // A std::map entry: the key/value pair plus a tree node's three links and colour.
+    static constexpr size_t NODE_INFO_ENTRY_BYTES = sizeof(std::pair<const Node, NodeScore>) + 4 * sizeof(void*);
+
     static bool isWalkable(const std::vector<std::vector<bool>>& walls, int x, int y);
     static bool hasForced(const std::vector<std::vector<bool>>& walls, int x, int y, const Direction& dir);
     static bool validDiagonalMove(const std::vector<std::vector<bool>>& walls, int x, int y, const Direction& dir);
@@ -49,7 +63,6 @@ private:
     static std::vector<JumpPoint> identifySuccessors(const std::vector<std::vector<bool>>& walls,
         const Node& node, const Node& end);
     static int movementCost(const Node& a, const Node& b);
-    static int heuristic(const Node& a, const Node& b);
     static std::vector<Node> reconstructPath(const std::map<Node, NodeScore>& nodeInfo,
         const std::vector<std::vector<bool>>& walls, Node current);
 };
\ No newline at end of file
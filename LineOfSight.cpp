@@ -0,0 +1,83 @@
+// LineOfSight.cpp
+#include "LineOfSight.h"
+#include <algorithm>
+
+namespace {
+    int64_t floorDiv(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+
+    int64_t ceilDiv(int64_t a, int64_t b) {
+        return -floorDiv(-a, b);
+    }
+}
+
+LineOfSight::LineOfSight(const Grid& grid)
+    : gridWidth(grid.width()),
+    gridHeight(grid.height()),
+    wordsPerRow((static_cast<size_t>(grid.width()) + 63) / 64),
+    wallBits(wordsPerRow * grid.height(), 0) {
+    for (int y = 0; y < gridHeight; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            if (!grid.isWalkable(x, y)) {
+                wallBits[y * wordsPerRow + x / 64] |= uint64_t{ 1 } << (x % 64);
+            }
+        }
+    }
+}
+
+// True when cells fromX..toX (inclusive) of row y are all free; one masked
+// word test per 64 cells.
+bool LineOfSight::spanFree(int y, int fromX, int toX) const {
+    if (y < 0 || y >= gridHeight || fromX < 0 || toX >= gridWidth) {
+        return false;
+    }
+
+    const uint64_t* row = &wallBits[y * wordsPerRow];
+    int firstWord = fromX / 64;
+    int lastWord = toX / 64;
+    for (int w = firstWord; w <= lastWord; w++) {
+        uint64_t mask = ~uint64_t{ 0 };
+        if (w == firstWord) mask &= ~uint64_t{ 0 } << (fromX % 64);
+        if (w == lastWord) mask &= ~uint64_t{ 0 } >> (63 - toX % 64);
+        if (row[w] & mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Walks the segment one row at a time, Bresenham style, but instead of
+// stepping cell by cell it works out the exact range of columns the segment
+// covers in each row and tests that whole span at once. Coordinates are
+// doubled so cell edges fall on integers and the arithmetic stays exact.
+bool LineOfSight::visible(const Node& a, const Node& b) const {
+    Node from = a.y <= b.y ? a : b;
+    Node to = a.y <= b.y ? b : a;
+    const int64_t dx = to.x - from.x;
+    const int64_t dy = to.y - from.y;
+
+    if (dy == 0) {
+        return spanFree(from.y, (std::min)(from.x, to.x), (std::max)(from.x, to.x));
+    }
+
+    for (int y = from.y; y <= to.y; y++) {
+        // Part of the segment inside this row, in doubled units: 2y - 1 .. 2y + 1
+        int64_t bandLow = (std::max)(int64_t{ 2 } * y - 1, int64_t{ 2 } * from.y);
+        int64_t bandHigh = (std::min)(int64_t{ 2 } * y + 1, int64_t{ 2 } * to.y);
+
+        // Doubled x along the segment is xNum / dy
+        int64_t xNumLow = 2 * from.x * dy + (bandLow - 2 * from.y) * dx;
+        int64_t xNumHigh = 2 * from.x * dy + (bandHigh - 2 * from.y) * dx;
+        if (xNumLow > xNumHigh) std::swap(xNumLow, xNumHigh);
+
+        // Cell x spans doubled 2x - 1 .. 2x + 1; edges count as touching
+        int firstX = static_cast<int>(ceilDiv(xNumLow - dy, 2 * dy));
+        int lastX = static_cast<int>(floorDiv(xNumHigh + dy, 2 * dy));
+        if (!spanFree(y, firstX, lastX)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+// LineOfSight.h
+#pragma once
+#include "Grid.h"
+#include "Node.h"
+#include <vector>
+#include <cstdint>
+
+// Line-of-sight queries between cell centres, checked a whole row span at a
+// time against per-row wall bitmasks.
+//
+// A segment is visible when every cell it touches is free, counting cells it
+// only touches at a corner or along an edge. That is the same rule the
+// EightConnected movement model applies to a single diagonal step (both
+// adjacent cardinal cells must be free), so a visible segment can always be
+// followed without cutting a wall corner.
+class LineOfSight {
+public:
+    explicit LineOfSight(const Grid& grid);
+
+    bool visible(const Node& a, const Node& b) const;
+
+    // Bytes of the wall masks built for grid.
+    static size_t bytesFor(const Grid& grid) {
+        return (static_cast<size_t>(grid.width()) + 63) / 64 * grid.height() * sizeof(uint64_t);
+    }
+
+private:
+    int gridWidth;
+    int gridHeight;
+    size_t wordsPerRow;
+    std::vector<uint64_t> wallBits;  // Row-major, bit x of row y set for a wall
+
+    bool spanFree(int y, int fromX, int toX) const;
+};
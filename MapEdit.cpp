@@ -0,0 +1,88 @@
+// MapEdit.cpp
+#include "MapEdit.h"
+#include <algorithm>
+#include <cstdlib>
+
+CellRect CellRect::united(const CellRect& other) const {
+    if (empty()) return other;
+    if (other.empty()) return *this;
+    return CellRect{
+        (std::min)(left, other.left),
+        (std::min)(top, other.top),
+        (std::max)(right, other.right),
+        (std::max)(bottom, other.bottom)
+    };
+}
+
+MapEditBatch& MapEditBatch::set(int x, int y, bool wall) {
+    cellEdits.push_back({ x, y, wall });
+    return *this;
+}
+
+MapEditBatch& MapEditBatch::fillRect(const CellRect& rect, bool wall) {
+    if (rect.empty()) {
+        return *this;
+    }
+
+    cellEdits.reserve(cellEdits.size() + static_cast<size_t>(rect.right - rect.left) * (rect.bottom - rect.top));
+    for (int y = rect.top; y < rect.bottom; y++) {
+        for (int x = rect.left; x < rect.right; x++) {
+            cellEdits.push_back({ x, y, wall });
+        }
+    }
+    return *this;
+}
+
+MapEditBatch& MapEditBatch::stamp(int x, int y, const std::vector<std::vector<bool>>& bitmap) {
+    for (size_t row = 0; row < bitmap.size(); row++) {
+        for (size_t column = 0; column < bitmap[row].size(); column++) {
+            cellEdits.push_back({ x + static_cast<int>(column), y + static_cast<int>(row), bitmap[row][column] });
+        }
+    }
+    return *this;
+}
+
+MapEditBatch& MapEditBatch::line(int fromX, int fromY, int toX, int toY, bool wall) {
+    int dx = std::abs(toX - fromX);
+    int dy = -std::abs(toY - fromY);
+    int stepX = fromX < toX ? 1 : -1;
+    int stepY = fromY < toY ? 1 : -1;
+    int error = dx + dy;
+    int x = fromX;
+    int y = fromY;
+    while (true) {
+        cellEdits.push_back({ x, y, wall });
+        if (x == toX && y == toY) {
+            break;
+        }
+        int doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x += stepX;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y += stepY;
+        }
+    }
+    return *this;
+}
+
+MapEditBatch& MapEditBatch::append(const std::vector<CellEdit>& edits) {
+    cellEdits.insert(cellEdits.end(), edits.begin(), edits.end());
+    return *this;
+}
+
+std::vector<CellEdit> MapEditBatch::applyTo(std::vector<std::vector<bool>>& walls) const {
+    std::vector<CellEdit> changed;
+    for (const CellEdit& edit : cellEdits) {
+        if (edit.y < 0 || edit.y >= static_cast<int>(walls.size()) ||
+            edit.x < 0 || edit.x >= static_cast<int>(walls[edit.y].size()) ||
+            walls[edit.y][edit.x] == edit.wall) {
+            continue;
+        }
+        walls[edit.y][edit.x] = edit.wall;
+        changed.push_back(edit);
+    }
+    return changed;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+// MapEdit.h
+#pragma once
+#include <vector>
+#include <cstddef>
+
+struct CellEdit {
+    int x, y;
+    bool wall;
+};
+
+// Cells [left, right) x [top, bottom).
+struct CellRect {
+    int left, top, right, bottom;
+    bool empty() const { return left >= right || top >= bottom; }
+    CellRect united(const CellRect& other) const;
+};
+
+// A list of wall changes applied together by World::applyEdits, so that
+// everything derived from the walls (renderer, component index, resumable
+// searches) is updated once per batch rather than once per cell. Edits apply
+// in the order they were added; a later edit of the same cell wins.
+class MapEditBatch {
+public:
+    MapEditBatch& set(int x, int y, bool wall);
+    MapEditBatch& fillRect(const CellRect& rect, bool wall = true);
+    MapEditBatch& clearRect(const CellRect& rect) { return fillRect(rect, false); }
+    // Copies bitmap (walls[y][x]) onto the map with its top-left corner at (x, y).
+    MapEditBatch& stamp(int x, int y, const std::vector<std::vector<bool>>& bitmap);
+    // Every cell on the Bresenham line between the two cells, e.g. a mouse
+    // stroke between two move events.
+    MapEditBatch& line(int fromX, int fromY, int toX, int toY, bool wall);
+    MapEditBatch& append(const std::vector<CellEdit>& edits);
+
+    // Writes the edits into walls (walls[y][x]), skipping cells outside it and
+    // edits that would not change the cell. Returns the edits that changed a
+    // cell, in order, for updating whatever is derived from the walls.
+    std::vector<CellEdit> applyTo(std::vector<std::vector<bool>>& walls) const;
+
+    const std::vector<CellEdit>& edits() const { return cellEdits; }
+    size_t size() const { return cellEdits.size(); }
+    bool empty() const { return cellEdits.empty(); }
+
+private:
+    std::vector<CellEdit> cellEdits;
+};
\ No newline at end of file
@@ -0,0 +1,12 @@
+// Node.h
+#pragma once
+
+struct Node {
+    int x, y;
+    bool operator==(const Node& other) const {
+        return x == other.x && y == other.y;
+    }
+    bool operator<(const Node& other) const {
+        return x < other.x || (x == other.x && y < other.y);
+    }
+};
\ No newline at end of file
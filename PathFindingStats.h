@@ -1,36 +1,40 @@
 // PathfindingStats.h
 #pragma once
 #include <string>
-#include <fstream>
-#include <chrono>
 #include <vector>
-#include <functional>
-#include "DijkstrasPathFinder.h"
+#include <cstdint>
+#include "Node.h"
+
+class StatsWriter;
 
 struct PathfindingResult {
     std::string algorithm;
     size_t pathLength;
     size_t nodesVisited;
     double timeMs;
-    std::string mapId;
+    uint64_t mapId;
+    int mapWidth;
+    int mapHeight;
+    Node start;
+    Node end;
+    uint64_t peakBytes = 0;  // SearchResult::memory.peakBytes, 0 when the finder does not report it
 };
 
 class PathfindingStats {
 public:
-    static std::string generateMapId(const std::vector<std::vector<bool>>& walls);
+    // 64-bit FNV-1a of the dimensions and wall layout. The same bytes hashed
+    // the same way as the old CSV map ids on 64-bit MSVC builds, but stable
+    // across compilers and machines.
+    static uint64_t generateMapId(const std::vector<std::vector<bool>>& walls);
+    // Appends the result to STATS_FILE (see StatsStore), stamped with the
+    // time, run, build and machine. Results are buffered and written in
+    // chunks of rows, the last on flushStats() or at exit.
     static void saveStats(const PathfindingResult& result);
-    static std::pair<std::vector<Node>, std::set<Node>> timePathfinding(
-        const std::string& algorithm,
-        const std::vector<std::vector<bool>>& walls,
-        const Node& start,
-        const Node& end,
-        std::function<std::pair<std::vector<Node>, std::set<Node>>(
-            const std::vector<std::vector<bool>>&,
-            const Node&,
-            const Node&)> pathfinder
-    );
+    static void flushStats();
 
 private:
     static const std::string STATS_FILE;
-    static std::hash<std::string> hasher;
+    static const size_t CHUNK_ROWS = 256;
+
+    static StatsWriter& writer();
 };
\ No newline at end of file
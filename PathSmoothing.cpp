@@ -0,0 +1,112 @@
+// PathSmoothing.cpp
+#include "PathSmoothing.h"
+#include "Constants.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+    Waypoint toWaypoint(const Node& node) {
+        return Waypoint{ static_cast<uint16_t>(node.x), static_cast<uint16_t>(node.y) };
+    }
+
+    int sign(int value) {
+        return (value > 0) - (value < 0);
+    }
+}
+
+WaypointPath toWaypoints(const std::vector<Node>& cellPath) {
+    WaypointPath waypoints;
+    if (cellPath.empty()) {
+        return waypoints;
+    }
+
+    waypoints.push_back(toWaypoint(cellPath.front()));
+    for (size_t i = 1; i + 1 < cellPath.size(); i++) {
+        int inX = sign(cellPath[i].x - cellPath[i - 1].x);
+        int inY = sign(cellPath[i].y - cellPath[i - 1].y);
+        int outX = sign(cellPath[i + 1].x - cellPath[i].x);
+        int outY = sign(cellPath[i + 1].y - cellPath[i].y);
+        if (inX != outX || inY != outY) {
+            waypoints.push_back(toWaypoint(cellPath[i]));
+        }
+    }
+    if (cellPath.size() > 1) {
+        waypoints.push_back(toWaypoint(cellPath.back()));
+    }
+    return waypoints;
+}
+
+// Greedy from each anchor: extend to the furthest next waypoint that is still
+// visible. Every kept segment was visible, so the result is as walkable as
+// the input.
+WaypointPath smoothPath(const LineOfSight& lineOfSight, const WaypointPath& path) {
+    if (path.size() <= 2) {
+        return path;
+    }
+
+    WaypointPath smoothed;
+    smoothed.push_back(path.front());
+    size_t anchor = 0;
+    for (size_t i = 1; i + 1 < path.size(); i++) {
+        if (!lineOfSight.visible(path[anchor].toNode(), path[i + 1].toNode())) {
+            smoothed.push_back(path[i]);
+            anchor = i;
+        }
+    }
+    smoothed.push_back(path.back());
+    return smoothed;
+}
+
+WaypointPath smoothPath(const LineOfSight& lineOfSight, const std::vector<Node>& cellPath) {
+    return smoothPath(lineOfSight, toWaypoints(cellPath));
+}
+
+// Walks each segment through exactly the cells it crosses, stepping
+// diagonally only where it passes through a cell corner. Those cells are a
+// subset of the ones LineOfSight checked, so they are free whenever the
+// segment was visible, and no step cuts a corner. (Bresenham would take a
+// diagonal step wherever the segment clips one of the two side cells,
+// cutting past the other.)
+std::vector<Node> rasterizeWaypoints(const WaypointPath& path) {
+    std::vector<Node> cells;
+    if (path.empty()) {
+        return cells;
+    }
+
+    cells.push_back(path.front().toNode());
+    for (size_t i = 1; i < path.size(); i++) {
+        int x = path[i - 1].x;
+        int y = path[i - 1].y;
+        const int dx = std::abs(path[i].x - x);
+        const int dy = std::abs(path[i].y - y);
+        const int stepX = x < path[i].x ? 1 : -1;
+        const int stepY = y < path[i].y ? 1 : -1;
+
+        // Compares where the segment next crosses a vertical cell edge
+        // (after (2 * ix + 1) / (2 * dx) of its length) with where it next
+        // crosses a horizontal one
+        for (int ix = 0, iy = 0; ix < dx || iy < dy;) {
+            int64_t decision = static_cast<int64_t>(2 * ix + 1) * dy - static_cast<int64_t>(2 * iy + 1) * dx;
+            if (decision <= 0) {
+                x += stepX;
+                ix++;
+            }
+            if (decision >= 0) {
+                y += stepY;
+                iy++;
+            }
+            cells.push_back(Node{ x, y });
+        }
+    }
+    return cells;
+}
+
+double waypointPathLength(const WaypointPath& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); i++) {
+        double dx = static_cast<double>(path[i].x) - path[i - 1].x;
+        double dy = static_cast<double>(path[i].y) - path[i - 1].y;
+        length += std::sqrt(dx * dx + dy * dy);
+    }
+    return length * Constants::STRAIGHT_COST;
+}
@@ -0,0 +1,33 @@
+// PathSmoothing.h
+#pragma once
+#include "Node.h"
+#include "LineOfSight.h"
+#include <vector>
+#include <cstdint>
+
+// Compact path vertex: 4 bytes instead of a Node's 8. Grids are far smaller
+// than 65536 cells per side.
+struct Waypoint {
+    uint16_t x, y;
+
+    Node toNode() const { return Node{ x, y }; }
+    bool operator==(const Waypoint& other) const { return x == other.x && y == other.y; }
+};
+
+using WaypointPath = std::vector<Waypoint>;
+
+// Keeps only the cells where a cell-by-cell path changes direction (plus both
+// ends); straight runs collapse to their end points.
+WaypointPath toWaypoints(const std::vector<Node>& cellPath);
+
+// String pulling: drops every waypoint the path can skip while keeping line
+// of sight between consecutive waypoints. Takes cell paths or waypoint paths.
+WaypointPath smoothPath(const LineOfSight& lineOfSight, const WaypointPath& path);
+WaypointPath smoothPath(const LineOfSight& lineOfSight, const std::vector<Node>& cellPath);
+
+// Cells an agent walks through between consecutive waypoints, for drawing and
+// for callers that need a cell path again.
+std::vector<Node> rasterizeWaypoints(const WaypointPath& path);
+
+// Euclidean length in the same units as the grid costs (STRAIGHT_COST per cell).
+double waypointPathLength(const WaypointPath& path);
@@ -0,0 +1,161 @@
+// PathfindingDaemon.cpp
+// Entry point of the pathfinding service: a console process that serves
+// ServiceProtocol requests on a Unix domain socket, so other programs can use
+// the search engines without the window. Built by PathfindingDaemon.vcxproj.
+//
+// Usage: PathfindingDaemon [socket path] [worker threads] [per-query memory limit in KB]
+#include "PathfindingService.h"
+#include "ServiceProtocol.h"
+#include "ServiceSocket.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace {
+    const char DEFAULT_SOCKET_PATH[] = "pathfinding.sock";
+    const int STATS_INTERVAL_SECONDS = 10;
+    const size_t MAX_BATCH = 64;  // PathfindingService's default
+    const int MIN_ACCEPT_BACKOFF_MS = 10;     // After running out of descriptors, doubling
+    const int MAX_ACCEPT_BACKOFF_MS = 1000;   // while it lasts
+
+    // Replies to pipelined queries are written from worker threads as the
+    // queries finish, so writes to one client are serialized here.
+    struct Connection {
+        LocalSocket socket;
+        std::mutex writeMutex;
+
+        explicit Connection(LocalSocket socket) : socket(std::move(socket)) {
+        }
+        void send(const std::vector<uint8_t>& frame) {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            socket.sendFrame(frame);
+        }
+    };
+
+    void serveClient(PathfindingService& service, std::shared_ptr<Connection> connection) {
+        while (std::optional<std::vector<uint8_t>> payload = connection->socket.receiveFrame()) {
+            MessageReader reader(std::move(*payload));
+            switch (reader.type().value_or(MessageType::Error)) {
+            case MessageType::LoadMap: {
+                auto walls = decodeLoadMap(reader);
+                if (!walls) {
+                    connection->send(encodeError(0, "malformed LoadMap"));
+                    break;
+                }
+                uint32_t mapId = service.loadMap(*walls);
+                connection->send(MessageWriter(MessageType::MapLoaded).write(mapId).frame());
+                break;
+            }
+            case MessageType::UnloadMap: {
+                uint32_t mapId = 0;
+                if (!reader.read(mapId) || !reader.atEnd()) {
+                    connection->send(encodeError(0, "malformed UnloadMap"));
+                    break;
+                }
+                if (!service.unloadMap(mapId)) {
+                    connection->send(encodeError(0, "unknown map id"));
+                    break;
+                }
+                connection->send(MessageWriter(MessageType::MapUnloaded).write(mapId).frame());
+                break;
+            }
+            case MessageType::Query: {
+                auto request = decodeQuery(reader);
+                if (!request) {
+                    connection->send(encodeError(0, "malformed Query"));
+                    break;
+                }
+                // The callback keeps the connection alive until the reply is written
+                std::optional<std::string> rejected = service.submit(*request, [connection](const QueryReply& reply) {
+                    connection->send(encodeQueryDone(reply));
+                });
+                if (rejected) {
+                    connection->send(encodeError(request->requestId, *rejected));
+                }
+                break;
+            }
+            case MessageType::Stats:
+                connection->send(encodeStatsReport(service.stats()));
+                break;
+            default:
+                connection->send(encodeError(0, "unknown message type"));
+                break;
+            }
+        }
+    }
+
+    void printStats(const ServiceStats& stats) {
+        std::cout << "queue depth " << stats.queueDepth << ", " << stats.batches << " batches" << std::endl;
+        for (const AlgorithmStats& algorithm : stats.algorithms) {
+            std::cout << "  " << algorithm.algorithm << ": " << algorithm.queries << " queries, mean "
+                << algorithm.meanMs << " ms, p50 " << algorithm.p50Ms << " ms, p99 " << algorithm.p99Ms
+                << " ms, max " << algorithm.maxMs << " ms, peak memory mean "
+                << static_cast<uint64_t>(algorithm.meanPeakBytes / 1024) << " KB, max "
+                << algorithm.maxPeakBytes / 1024 << " KB" << std::endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = argc > 1 ? argv[1] : DEFAULT_SOCKET_PATH;
+    size_t threadCount = argc > 2 ? static_cast<size_t>(std::strtoul(argv[2], nullptr, 10)) : 0;
+    size_t memoryLimit = argc > 3 ? static_cast<size_t>(std::strtoull(argv[3], nullptr, 10)) * 1024 : 0;
+
+    std::optional<LocalSocket> listener = LocalSocket::listen(socketPath);
+    if (!listener) {
+        std::cerr << "Cannot listen on " << socketPath << std::endl;
+        return 1;
+    }
+
+    static PathfindingService service(threadCount, MAX_BATCH, memoryLimit);  // Never destroyed; see the end of main
+    std::cout << "Serving pathfinding queries on " << socketPath << std::endl;
+
+    std::thread([] {
+        uint64_t reportedBatches = 0;
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::seconds(STATS_INTERVAL_SECONDS));
+            ServiceStats stats = service.stats();
+            if (stats.batches != reportedBatches) {
+                printStats(stats);
+                reportedBatches = stats.batches;
+            }
+        }
+    }).detach();
+
+    // Failures of one connection, or running out of descriptors while many
+    // clients are connected, must not take the service down; only a broken
+    // listener does
+    LocalSocket::AcceptError error;
+    int backoffMs = 0;
+    while (true) {
+        std::optional<LocalSocket> client = listener->accept(&error);
+        if (client) {
+            backoffMs = 0;
+            auto connection = std::make_shared<Connection>(std::move(*client));
+            std::thread([connection] { serveClient(service, connection); }).detach();
+        }
+        else if (error.kind == LocalSocket::AcceptError::OutOfResources) {
+            if (backoffMs == 0) {
+                std::cerr << "Accept failed: " << std::system_category().message(error.code)
+                    << " (error " << error.code << "); retrying" << std::endl;
+            }
+            backoffMs = backoffMs == 0 ? MIN_ACCEPT_BACKOFF_MS : (std::min)(backoffMs * 2, MAX_ACCEPT_BACKOFF_MS);
+            std::this_thread::sleep_for(std::chrono::milliseconds(backoffMs));
+        }
+        else if (error.kind == LocalSocket::AcceptError::Fatal) {
+            break;
+        }
+    }
+    // Client and stats threads are detached and still use the service, so
+    // exit without running static destructors
+    std::cerr << "Accept failed: " << std::system_category().message(error.code)
+        << " (error " << error.code << "); shutting down" << std::endl;
+    std::cout.flush();
+    std::quick_exit(1);
+}
\ No newline at end of file
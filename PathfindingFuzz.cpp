@@ -0,0 +1,126 @@
+// PathfindingFuzz.cpp
+// Entry point of the differential fuzz harness: runs every finder on random
+// maps and queries, checks the answers against a reference Dijkstra (see
+// DifferentialFuzzer) and prints expansions and time relative to it. Seeds of
+// failing cases are appended to FAILURES_FILE. Built by PathfindingFuzz.vcxproj.
+//
+// Usage: PathfindingFuzz [cases] [first seed] [--record <stats file> [--run <label>]]
+//        PathfindingFuzz --seed <seed>   (re-runs one case and prints its map)
+//
+// --record appends every query's result to a stats file (see StatsStore) for
+// PathfindingReport; the run label defaults to the start time.
+#include "DifferentialFuzzer.h"
+#include "StatsStore.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace {
+    const char FAILURES_FILE[] = "fuzz_failures.txt";
+    const uint64_t DEFAULT_CASES = 500;
+    const size_t MAX_PRINTED_FAILURES = 20;
+
+    void printMap(const FuzzCase& fuzzCase) {
+        std::cout << "Seed " << fuzzCase.seed << ": " << fuzzCase.kind << ", " << fuzzCase.walls[0].size()
+            << "x" << fuzzCase.walls.size() << std::endl;
+        for (const auto& row : fuzzCase.walls) {
+            for (bool wall : row) {
+                std::cout << (wall ? '#' : '.');
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    void printFailure(const FuzzFailure& failure) {
+        std::cout << "seed " << failure.seed << " " << failure.finder << " (" << failure.start.x << ","
+            << failure.start.y << ") -> (" << failure.end.x << "," << failure.end.y << "): "
+            << failure.problem << std::endl;
+    }
+
+    void printStats(const std::vector<FuzzFinderStats>& stats) {
+        std::cout << std::left << std::setw(20) << "Finder" << std::right << std::setw(9) << "Queries"
+            << std::setw(10) << "Failures" << std::setw(14) << "Expanded %" << std::setw(12) << "Time x" << std::endl;
+        for (const FuzzFinderStats& finder : stats) {
+            double expanded = finder.referenceExpanded == 0 ? 0.0 : 100.0 * finder.nodesExpanded / finder.referenceExpanded;
+            double time = finder.referenceMs <= 0.0 ? 0.0 : finder.timeMs / finder.referenceMs;
+            std::cout << std::left << std::setw(20) << finder.name << std::right << std::setw(9) << finder.queries
+                << std::setw(10) << finder.failures << std::fixed << std::setprecision(1) << std::setw(14) << expanded
+                << std::setprecision(2) << std::setw(12) << time << std::endl;
+        }
+        std::cout << "(relative to the reference Dijkstra on the same queries)" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool replay = false;
+    uint64_t firstSeed = 1;
+    uint64_t cases = DEFAULT_CASES;
+    std::string recordFile;
+    std::string runLabel = StatsWriter::defaultRunLabel();
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            replay = true;
+            firstSeed = std::strtoull(argv[++i], nullptr, 10);
+            cases = 1;
+        }
+        else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--run") == 0 && hasValue) {
+            runLabel = argv[++i];
+        }
+        else if (!replay && positional == 0) {
+            cases = std::strtoull(argv[i], nullptr, 10);
+            positional++;
+        }
+        else if (!replay && positional == 1) {
+            firstSeed = std::strtoull(argv[i], nullptr, 10);
+            positional++;
+        }
+    }
+
+    DifferentialFuzzer fuzzer;
+    std::unique_ptr<StatsWriter> recorder;
+    if (!recordFile.empty()) {
+        recorder = std::make_unique<StatsWriter>(recordFile, runLabel);
+        fuzzer.recordTo(recorder.get());
+    }
+    std::set<uint64_t> failingSeeds;
+    size_t failureCount = 0;
+    for (uint64_t seed = firstSeed; seed < firstSeed + cases; seed++) {
+        FuzzCase fuzzCase = FuzzCase::generate(seed);
+        if (replay) {
+            printMap(fuzzCase);
+        }
+        for (const FuzzFailure& failure : fuzzer.runCase(fuzzCase)) {
+            if (replay || failureCount < MAX_PRINTED_FAILURES) {
+                printFailure(failure);
+            }
+            failureCount++;
+            if (failingSeeds.insert(seed).second) {
+                std::ofstream file(FAILURES_FILE, std::ios::app);
+                file << seed << " " << failure.finder << ": " << failure.problem << "\n";
+            }
+        }
+    }
+
+    printStats(fuzzer.stats());
+    if (recorder) {
+        recorder->flush();
+        std::cout << "Results recorded to " << recordFile << " as run \"" << runLabel << "\"" << std::endl;
+    }
+    if (failureCount == 0) {
+        std::cout << "All " << cases << " cases passed" << std::endl;
+        return 0;
+    }
+    std::cout << failureCount << " failures in " << failingSeeds.size() << " of " << cases
+        << " cases; seeds appended to " << FAILURES_FILE << std::endl;
+    return 1;
+}
\ No newline at end of file
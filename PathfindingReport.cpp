@@ -0,0 +1,349 @@
+// PathfindingReport.cpp
+// Reads stats files written by the app and PathfindingFuzz (see StatsStore)
+// and summarises or compares runs. Built by PathfindingReport.vcxproj.
+//
+// Usage: PathfindingReport runs <stats file>...
+//        PathfindingReport summary <stats file>... [--run <label>] [--by-map]
+//        PathfindingReport compare <baseline run> <candidate run> <stats file>... [--threshold <ratio>] [--by-map]
+//        PathfindingReport import <legacy csv> <stats file> [--run <label>]
+//
+// compare pairs the two runs query by query (same map, algorithm and
+// endpoints) and flags a group as a regression when the candidate is slower
+// by more than the threshold (default 1.10), expands more nodes or holds more
+// search memory by more than it, or returns paths of a different length. It
+// exits with 1 if anything regressed. Rows written before peak memory was
+// recorded read as 0 bytes and leave the memory ratio at 1.
+#include "StatsStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    const double DEFAULT_THRESHOLD = 1.10;
+    const char LEGACY_RUN[] = "legacy csv";
+
+    struct Options {
+        std::vector<std::string> positional;
+        std::string run;
+        double threshold = DEFAULT_THRESHOLD;
+        bool byMap = false;
+    };
+
+    Options parseOptions(int argc, char* argv[], int first) {
+        Options options;
+        for (int i = first; i < argc; i++) {
+            if (std::strcmp(argv[i], "--run") == 0 && i + 1 < argc) {
+                options.run = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+                options.threshold = std::strtod(argv[++i], nullptr);
+            }
+            else if (std::strcmp(argv[i], "--by-map") == 0) {
+                options.byMap = true;
+            }
+            else {
+                options.positional.push_back(argv[i]);
+            }
+        }
+        return options;
+    }
+
+    bool loadTables(StatsTable& table, const std::vector<std::string>& files) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        bool complete = true;
+        for (const std::string& file : files) {
+            if (!table.loadFile(file)) {
+                std::cerr << "Could not read all of " << file << std::endl;
+                complete = false;
+            }
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - startTime).count();
+        std::cout << "Loaded " << table.size() << " rows from " << files.size() << " file(s) in " << ms << " ms" << std::endl;
+        return complete || !table.empty();
+    }
+
+    // Nearest-rank percentile of values, which it sorts.
+    double percentile(std::vector<double>& values, double p) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t rank = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+        return values[(std::min)(rank, values.size() - 1)];
+    }
+
+    std::string mapLabel(uint64_t mapId) {
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0') << std::setw(16) << mapId;
+        return ss.str();
+    }
+
+    // Rows grouped by algorithm, or by map and algorithm, in name order.
+    struct GroupKey {
+        uint64_t mapId;
+        std::string algorithm;
+        bool operator<(const GroupKey& other) const {
+            return mapId != other.mapId ? mapId < other.mapId : algorithm < other.algorithm;
+        }
+    };
+
+    std::string groupLabel(const GroupKey& key, bool byMap) {
+        return byMap ? mapLabel(key.mapId) + " " + key.algorithm : key.algorithm;
+    }
+
+    int listRuns(const StatsTable& table) {
+        struct RunInfo {
+            size_t rows = 0;
+            uint32_t build = 0;
+            uint32_t machine = 0;
+            std::set<uint32_t> algorithms;
+            std::set<uint64_t> maps;
+        };
+        std::map<std::string, RunInfo> runs;
+        for (size_t i = 0; i < table.size(); i++) {
+            RunInfo& info = runs[table.text(table.run[i])];
+            info.rows++;
+            info.build = table.build[i];
+            info.machine = table.machine[i];
+            info.algorithms.insert(table.algorithm[i]);
+            info.maps.insert(table.mapId[i]);
+        }
+
+        std::cout << std::left << std::setw(24) << "Run" << std::right << std::setw(10) << "Rows" << std::setw(8) << "Algos"
+            << std::setw(8) << "Maps" << "  " << std::left << std::setw(30) << "Build" << "Machine" << std::endl;
+        for (const auto& [label, info] : runs) {
+            std::cout << std::left << std::setw(24) << label << std::right << std::setw(10) << info.rows
+                << std::setw(8) << info.algorithms.size() << std::setw(8) << info.maps.size() << "  "
+                << std::left << std::setw(30) << table.text(info.build) << table.text(info.machine) << std::endl;
+        }
+        return 0;
+    }
+
+    int summarise(const StatsTable& table, const Options& options) {
+        struct Group {
+            std::vector<double> times;
+            double expanded = 0.0;
+            double pathLength = 0.0;
+            double peakBytes = 0.0;
+            uint64_t maxPeakBytes = 0;
+        };
+        // Runs in label order, each with its groups in name order
+        std::map<std::string, std::map<GroupKey, Group>> runs;
+        for (size_t i = 0; i < table.size(); i++) {
+            const std::string& run = table.text(table.run[i]);
+            if (!options.run.empty() && run != options.run) continue;
+            Group& group = runs[run][GroupKey{ options.byMap ? table.mapId[i] : 0, table.text(table.algorithm[i]) }];
+            group.times.push_back(table.timeMs[i]);
+            group.expanded += table.nodesExpanded[i];
+            group.pathLength += table.pathLength[i];
+            group.peakBytes += static_cast<double>(table.peakBytes[i]);
+            group.maxPeakBytes = (std::max)(group.maxPeakBytes, table.peakBytes[i]);
+        }
+
+        for (auto& [run, groups] : runs) {
+            std::cout << std::endl << "Run " << run << std::endl;
+            std::cout << std::left << std::setw(options.byMap ? 40 : 24) << (options.byMap ? "Map / algorithm" : "Algorithm")
+                << std::right << std::setw(9) << "Queries" << std::setw(11) << "Mean ms" << std::setw(10) << "p50"
+                << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(12) << "Expanded" << std::setw(9) << "Path"
+                << std::setw(10) << "Peak KB" << std::setw(10) << "Max KB" << std::endl;
+            for (auto& [key, group] : groups) {
+                size_t n = group.times.size();
+                double total = 0.0;
+                for (double t : group.times) total += t;
+                std::cout << std::left << std::setw(options.byMap ? 40 : 24) << groupLabel(key, options.byMap)
+                    << std::right << std::setw(9) << n << std::fixed << std::setprecision(3)
+                    << std::setw(11) << total / n << std::setw(10) << percentile(group.times, 50)
+                    << std::setw(10) << percentile(group.times, 90) << std::setw(10) << percentile(group.times, 99)
+                    << std::setprecision(0) << std::setw(12) << group.expanded / n
+                    << std::setprecision(1) << std::setw(9) << group.pathLength / n
+                    << std::setprecision(0) << std::setw(10) << group.peakBytes / n / 1024
+                    << std::setw(10) << group.maxPeakBytes / 1024 << std::endl;
+            }
+        }
+        return 0;
+    }
+
+    // One query (map, algorithm, endpoints) as seen in each of the two runs.
+    struct QueryKey {
+        uint64_t mapId;
+        uint32_t algorithm;
+        uint16_t startX, startY, endX, endY;
+        bool operator==(const QueryKey& other) const {
+            return mapId == other.mapId && algorithm == other.algorithm && startX == other.startX
+                && startY == other.startY && endX == other.endX && endY == other.endY;
+        }
+    };
+
+    struct QueryKeyHash {
+        size_t operator()(const QueryKey& key) const {
+            uint64_t hash = key.mapId ^ (uint64_t{ key.algorithm } << 48);
+            hash ^= (uint64_t{ key.startX } | uint64_t{ key.startY } << 16 | uint64_t{ key.endX } << 32 | uint64_t{ key.endY } << 48)
+                * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    struct QuerySide {
+        double timeMs = 0.0;
+        double expanded = 0.0;
+        double peakBytes = 0.0;
+        uint32_t pathLength = 0;
+        size_t count = 0;
+    };
+
+    int compare(const StatsTable& table, const std::string& baseline, const std::string& candidate, const Options& options) {
+        std::unordered_map<QueryKey, QuerySide[2], QueryKeyHash> queries;
+        for (size_t i = 0; i < table.size(); i++) {
+            const std::string& run = table.text(table.run[i]);
+            int side = run == baseline ? 0 : run == candidate ? 1 : -1;
+            if (side < 0) continue;
+            QuerySide& query = queries[QueryKey{ table.mapId[i], table.algorithm[i],
+                table.startX[i], table.startY[i], table.endX[i], table.endY[i] }][side];
+            query.timeMs += table.timeMs[i];
+            query.expanded += table.nodesExpanded[i];
+            query.peakBytes += static_cast<double>(table.peakBytes[i]);
+            query.pathLength = table.pathLength[i];
+            query.count++;
+        }
+
+        struct Group {
+            std::vector<double> speedups;  // Per query timed in both, baseline time / candidate time
+            double baselineMs = 0.0;
+            double candidateMs = 0.0;
+            double baselineExpanded = 0.0;
+            double candidateExpanded = 0.0;
+            double baselinePeakBytes = 0.0;
+            double candidatePeakBytes = 0.0;
+            size_t queries = 0;
+            size_t pathChanges = 0;
+        };
+        std::map<GroupKey, Group> groups;
+        size_t unpaired = 0;
+        for (const auto& [key, sides] : queries) {
+            if (sides[0].count == 0 || sides[1].count == 0) {
+                unpaired++;
+                continue;
+            }
+            // Repeats of a query are averaged
+            double baseMs = sides[0].timeMs / sides[0].count;
+            double candidateMs = sides[1].timeMs / sides[1].count;
+            Group& group = groups[GroupKey{ options.byMap ? key.mapId : 0, table.text(key.algorithm) }];
+            group.queries++;
+            if (baseMs > 0.0 && candidateMs > 0.0) {
+                group.speedups.push_back(baseMs / candidateMs);
+            }
+            group.baselineMs += baseMs;
+            group.candidateMs += candidateMs;
+            group.baselineExpanded += sides[0].expanded / sides[0].count;
+            group.candidateExpanded += sides[1].expanded / sides[1].count;
+            group.baselinePeakBytes += sides[0].peakBytes / sides[0].count;
+            group.candidatePeakBytes += sides[1].peakBytes / sides[1].count;
+            if (sides[0].pathLength != sides[1].pathLength) {
+                group.pathChanges++;
+            }
+        }
+        if (groups.empty()) {
+            std::cerr << "No queries appear in both \"" << baseline << "\" and \"" << candidate << "\"" << std::endl;
+            return 2;
+        }
+
+        std::cout << "Speed-up of \"" << candidate << "\" over \"" << baseline << "\" (above 1 is faster); "
+            << "per-query percentiles, total-time ratio" << std::endl;
+        std::cout << std::left << std::setw(options.byMap ? 40 : 24) << (options.byMap ? "Map / algorithm" : "Algorithm")
+            << std::right << std::setw(9) << "Queries" << std::setw(8) << "p10" << std::setw(8) << "p50" << std::setw(8) << "p90"
+            << std::setw(9) << "Total" << std::setw(11) << "Expanded" << std::setw(9) << "Memory" << std::setw(9) << "Paths" << std::endl;
+        size_t regressions = 0;
+        for (auto& [key, group] : groups) {
+            double speedup = group.candidateMs > 0.0 ? group.baselineMs / group.candidateMs : 1.0;
+            double expandedRatio = group.baselineExpanded > 0.0 ? group.candidateExpanded / group.baselineExpanded : 1.0;
+            double memoryRatio = group.baselinePeakBytes > 0.0 && group.candidatePeakBytes > 0.0
+                ? group.candidatePeakBytes / group.baselinePeakBytes : 1.0;
+            bool regressed = speedup * options.threshold < 1.0 || expandedRatio > options.threshold
+                || memoryRatio > options.threshold || group.pathChanges > 0;
+            regressions += regressed ? 1 : 0;
+            std::cout << std::left << std::setw(options.byMap ? 40 : 24) << groupLabel(key, options.byMap)
+                << std::right << std::setw(9) << group.queries << std::fixed << std::setprecision(2)
+                << std::setw(8) << percentile(group.speedups, 10) << std::setw(8) << percentile(group.speedups, 50)
+                << std::setw(8) << percentile(group.speedups, 90) << std::setw(9) << speedup
+                << std::setw(11) << expandedRatio << std::setw(9) << memoryRatio << std::setw(9) << group.pathChanges
+                << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+        if (unpaired > 0) {
+            std::cout << unpaired << " queries appear in only one of the runs and were skipped" << std::endl;
+        }
+        std::cout << regressions << " of " << groups.size() << " groups regressed (threshold " << options.threshold << ")" << std::endl;
+        return regressions > 0 ? 1 : 0;
+    }
+
+    int importLegacy(const std::string& csvFile, const std::string& statsFile, const Options& options) {
+        StatsTable table;
+        long long rows = table.importCsv(csvFile, options.run.empty() ? LEGACY_RUN : options.run);
+        if (rows < 0) {
+            std::cerr << "Could not open " << csvFile << std::endl;
+            return 2;
+        }
+        if (!table.appendToFile(statsFile)) {
+            std::cerr << "Could not write " << statsFile << std::endl;
+            return 2;
+        }
+        std::cout << "Imported " << rows << " rows from " << csvFile << " into " << statsFile << std::endl;
+        return 0;
+    }
+
+    int usage() {
+        std::cerr << "Usage: PathfindingReport runs <stats file>...\n"
+            << "       PathfindingReport summary <stats file>... [--run <label>] [--by-map]\n"
+            << "       PathfindingReport compare <baseline run> <candidate run> <stats file>... [--threshold <ratio>] [--by-map]\n"
+            << "       PathfindingReport import <legacy csv> <stats file> [--run <label>]" << std::endl;
+        return 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage();
+    }
+    const std::string command = argv[1];
+    Options options = parseOptions(argc, argv, 2);
+
+    if (command == "import") {
+        return options.positional.size() == 2 ? importLegacy(options.positional[0], options.positional[1], options) : usage();
+    }
+
+    std::vector<std::string> files = options.positional;
+    std::string baseline;
+    std::string candidate;
+    if (command == "compare") {
+        if (files.size() < 3) {
+            return usage();
+        }
+        baseline = files[0];
+        candidate = files[1];
+        files.erase(files.begin(), files.begin() + 2);
+    }
+    else if (command != "runs" && command != "summary") {
+        return usage();
+    }
+
+    StatsTable table;
+    if (files.empty() || !loadTables(table, files)) {
+        return 2;
+    }
+    if (command == "runs") {
+        return listRuns(table);
+    }
+    if (command == "summary") {
+        return summarise(table, options);
+    }
+    return compare(table, baseline, candidate, options);
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+// PathfindingService.cpp
+#include "PathfindingService.h"
+#include "AsyncPathfinder.h"
+#include "JPSPathFinder.h"
+#include <algorithm>
+
+PathfindingService::LoadedMap::LoadedMap(const std::vector<std::vector<bool>>& walls)
+    : walls(walls),
+    grid(walls, Grid::preferredLayout(walls.empty() ? 0 : static_cast<int>(walls[0].size()))),
+    components(grid),
+    deadEnds(std::make_shared<const DeadEndIndex>(grid)) {
+}
+
+void PathfindingService::LatencyLog::add(double ms, uint64_t peakBytes) {
+    queries++;
+    totalMs += ms;
+    maxMs = (std::max)(maxMs, ms);
+    totalPeakBytes += static_cast<double>(peakBytes);
+    maxPeakBytes = (std::max)(maxPeakBytes, peakBytes);
+    if (recentMs.size() < WINDOW) {
+        recentMs.push_back(ms);
+    }
+    else {
+        recentMs[nextSlot] = ms;
+        nextSlot = (nextSlot + 1) % WINDOW;
+    }
+}
+
+PathfindingService::PathfindingService(size_t threadCount, size_t maxBatch, size_t memoryLimit)
+    : maxBatch((std::max)(maxBatch, size_t{ 1 })), memoryLimit(memoryLimit), pool(threadCount) {
+}
+
+uint32_t PathfindingService::loadMap(const std::vector<std::vector<bool>>& walls) {
+    auto map = std::make_shared<LoadedMap>(walls);  // Built outside the lock
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t id = nextMapId++;
+    maps.emplace(id, std::move(map));
+    return id;
+}
+
+bool PathfindingService::unloadMap(uint32_t mapId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maps.erase(mapId) != 0;  // Pending queries hold their own reference
+}
+
+std::optional<std::string> PathfindingService::submit(const QueryRequest& request, ReplyCallback reply) {
+    if (!AsyncPathfinder::isKnownAlgorithm(request.algorithm)) {
+        return "unknown algorithm";
+    }
+    if (request.tieBreak >= TIE_BREAK_POLICY_COUNT) {
+        return "unknown tie-break policy";
+    }
+
+    bool scheduleDrain = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto map = maps.find(request.mapId);
+        if (map == maps.end()) {
+            return "unknown map id";
+        }
+        const Grid& grid = map->second->grid;
+        auto inside = [&grid](const Node& node) {
+            return node.x >= 0 && node.x < grid.width() && node.y >= 0 && node.y < grid.height();
+        };
+        if (!inside(request.start) || !inside(request.end)) {
+            return "start or end outside the map";
+        }
+        pending.push_back(PendingQuery{ request, std::move(reply), map->second, std::chrono::steady_clock::now() });
+
+        // Busy drains pick the query up with their next batch
+        if (drainsScheduled < pool.threadCount()) {
+            drainsScheduled++;
+            scheduleDrain = true;
+        }
+    }
+    if (scheduleDrain) {
+        pool.submit([this] { drain(); });
+    }
+    return std::nullopt;
+}
+
+// Runs batches until no queries are left waiting.
+void PathfindingService::drain() {
+    while (true) {
+        std::vector<PendingQuery> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (pending.empty()) {
+                drainsScheduled--;
+                return;
+            }
+            size_t count = (std::min)(pending.size(), maxBatch);
+            batch.assign(std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.begin() + count));
+            pending.erase(pending.begin(), pending.begin() + count);
+            batchCount++;
+        }
+
+        // Queries on the same map run back to back while its data is in cache
+        std::stable_sort(batch.begin(), batch.end(), [](const PendingQuery& a, const PendingQuery& b) {
+            return a.request.mapId < b.request.mapId;
+        });
+
+        for (PendingQuery& query : batch) {
+            // The tighter of the service's cap and the query's own
+            size_t limit = query.request.memoryLimit == 0 ? memoryLimit
+                : memoryLimit == 0 ? static_cast<size_t>(query.request.memoryLimit)
+                : (std::min)(memoryLimit, static_cast<size_t>(query.request.memoryLimit));
+            QueryReply reply = runQuery(*query.map, query.request, limit);
+            // Measured before replying, so a client slow to read its replies
+            // does not show up as search latency
+            double latencyMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - query.arrived).count();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                latencies[query.request.algorithm].add(latencyMs, reply.peakBytes);
+            }
+            query.reply(reply);
+        }
+    }
+}
+
+QueryReply PathfindingService::runQuery(LoadedMap& map, const QueryRequest& request, size_t memoryLimit) {
+    QueryReply reply;
+    reply.requestId = request.requestId;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    bool reachable;
+    {
+        std::lock_guard<std::mutex> lock(map.componentsMutex);
+        reachable = map.components.connected(request.start, request.end);
+    }
+
+    if (reachable) {
+        PathQuery query{
+            request.algorithm,
+            request.start,
+            request.end,
+            static_cast<TieBreakPolicy>(request.tieBreak),
+            false,
+            map.deadEnds,
+            memoryLimit,
+            true
+        };
+        SearchResult result;
+        if (request.algorithm == "JPS") {
+            // On the walls kept for it rather than through runQuery, which would rebuild them
+            SearchControl control;
+            if (memoryLimit != 0) {
+                control.setMemoryLimit(memoryLimit);
+            }
+            result = JPSPathFinder::search(map.walls, request.start, request.end, &control);
+            if (result.status == SearchStatus::MemoryLimit) {
+                result = AsyncPathfinder::runLowMemoryFallback(map.grid, query, result, &control);
+            }
+        }
+        else {
+            result = AsyncPathfinder::runQuery(map.grid, query);
+        }
+        reply.status = result.status;
+        reply.cost = result.cost;
+        reply.nodesExpanded = result.nodesExpanded;
+        reply.peakBytes = result.memory.peakBytes;
+        reply.path = std::move(result.path);
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    reply.searchMs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0;
+    return reply;
+}
+
+ServiceStats PathfindingService::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ServiceStats stats;
+    stats.queueDepth = pending.size();
+    stats.batches = batchCount;
+    for (const auto& [algorithm, log] : latencies) {
+        std::vector<double> sorted = log.recentMs;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            return sorted.empty() ? 0.0 : sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+        };
+        stats.algorithms.push_back(AlgorithmStats{
+            algorithm,
+            log.queries,
+            log.queries == 0 ? 0.0 : log.totalMs / log.queries,
+            percentile(0.5),
+            percentile(0.99),
+            log.maxMs,
+            log.queries == 0 ? 0.0 : log.totalPeakBytes / log.queries,
+            log.maxPeakBytes
+        });
+    }
+    return stats;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+// PathfindingService.h
+#pragma once
+#include "Grid.h"
+#include "ComponentIndex.h"
+#include "DeadEndIndex.h"
+#include "ServiceProtocol.h"
+#include "WorkerPool.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The search engines without the window: maps are loaded once and kept warm
+// (flat Grid, the nested walls JPS reads, component index, dead-end index),
+// and queries are answered on a worker pool under the same algorithm names
+// World uses.
+//
+// Queries are coalesced: at most one drain task per worker is in the pool,
+// and each takes every query that arrived since (up to maxBatch), grouped by
+// map. Under load this turns thousands of tiny pool tasks into a few large
+// ones that keep one map's data hot. Tracks reply latency and peak search
+// memory per algorithm.
+//
+// memoryLimit caps the bytes any one query's search may hold (0 for no cap),
+// so a node can be sized for its worker count; a query's own limit can only
+// lower it. Queries over it are answered by Compact A* within the same cap.
+class PathfindingService {
+public:
+    using ReplyCallback = std::function<void(const QueryReply&)>;
+
+    explicit PathfindingService(size_t threadCount = 0, size_t maxBatch = 64, size_t memoryLimit = 0);
+
+    // Returns the new map's id (never 0).
+    uint32_t loadMap(const std::vector<std::vector<bool>>& walls);
+    // Frees the map once its queued and running queries are done; later
+    // queries on it are rejected. False if the id is unknown.
+    bool unloadMap(uint32_t mapId);
+
+    // Queues the query; reply is called on a worker thread. Returns why the
+    // query was rejected, without queueing it: an unknown map, algorithm or
+    // tie-break policy, or an end point outside the map.
+    std::optional<std::string> submit(const QueryRequest& request, ReplyCallback reply);
+
+    ServiceStats stats() const;
+
+private:
+    struct LoadedMap {
+        std::vector<std::vector<bool>> walls;
+        Grid grid;
+        std::mutex componentsMutex;  // connected() compresses paths as it goes
+        ComponentIndex components;
+        std::shared_ptr<const DeadEndIndex> deadEnds;  // Read-only once built, so shared without a lock
+
+        explicit LoadedMap(const std::vector<std::vector<bool>>& walls);
+    };
+
+    struct PendingQuery {
+        QueryRequest request;
+        ReplyCallback reply;
+        std::shared_ptr<LoadedMap> map;
+        std::chrono::steady_clock::time_point arrived;
+    };
+
+    struct LatencyLog {
+        static constexpr size_t WINDOW = 4096;  // Percentiles cover the most recent queries
+
+        uint64_t queries = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        std::vector<double> recentMs;
+        size_t nextSlot = 0;
+        double totalPeakBytes = 0.0;
+        uint64_t maxPeakBytes = 0;
+
+        void add(double ms, uint64_t peakBytes);
+    };
+
+    size_t maxBatch;
+    size_t memoryLimit;
+    mutable std::mutex mutex;  // Guards everything below except pool
+    std::unordered_map<uint32_t, std::shared_ptr<LoadedMap>> maps;
+    uint32_t nextMapId = 1;
+    std::deque<PendingQuery> pending;
+    size_t drainsScheduled = 0;
+    uint64_t batchCount = 0;
+    std::map<std::string, LatencyLog> latencies;
+    WorkerPool pool;  // Last, so its workers are joined before the members above go away
+
+    void drain();
+    static QueryReply runQuery(LoadedMap& map, const QueryRequest& request, size_t memoryLimit);
+};
\ No newline at end of file
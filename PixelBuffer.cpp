@@ -0,0 +1,129 @@
+// PixelBuffer.cpp
+#include "PixelBuffer.h"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+    void writeBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint32_t crc32(const uint8_t* data, size_t length) {
+        static const std::vector<uint32_t> table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[n] = c;
+            }
+            return t;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < length; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> chunk;
+        writeBigEndian(chunk, static_cast<uint32_t>(payload.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), payload.begin(), payload.end());
+        writeBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+        file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    }
+}
+
+PixelBuffer::PixelBuffer(int width, int height, uint32_t color)
+    : bufferWidth(width), bufferHeight(height), pixels(static_cast<size_t>(width) * height, color) {
+}
+
+void PixelBuffer::fillRect(const PixelRect& rect, uint32_t color) {
+    int left = (std::max)(rect.left, 0);
+    int top = (std::max)(rect.top, 0);
+    int right = (std::min)(rect.right, bufferWidth);
+    int bottom = (std::min)(rect.bottom, bufferHeight);
+    for (int y = top; y < bottom; y++) {
+        uint32_t* line = pixels.data() + static_cast<size_t>(y) * bufferWidth;
+        std::fill(line + left, line + right, color);
+    }
+}
+
+bool PixelBuffer::writePPM(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file << "P6\n" << bufferWidth << " " << bufferHeight << "\n255\n";
+    std::vector<uint8_t> line(static_cast<size_t>(bufferWidth) * 3);
+    for (int y = 0; y < bufferHeight; y++) {
+        const uint32_t* source = row(y);
+        for (int x = 0; x < bufferWidth; x++) {
+            line[x * 3] = static_cast<uint8_t>(source[x] >> 16);
+            line[x * 3 + 1] = static_cast<uint8_t>(source[x] >> 8);
+            line[x * 3 + 2] = static_cast<uint8_t>(source[x]);
+        }
+        file.write(reinterpret_cast<const char*>(line.data()), line.size());
+    }
+    return static_cast<bool>(file);
+}
+
+// 8-bit RGB PNG using stored (uncompressed) deflate blocks, so no zlib is needed.
+bool PixelBuffer::writePNG(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> header;
+    writeBigEndian(header, static_cast<uint32_t>(bufferWidth));
+    writeBigEndian(header, static_cast<uint32_t>(bufferHeight));
+    header.insert(header.end(), { 8, 2, 0, 0, 0 });  // 8-bit, truecolour, deflate, no filter, no interlace
+    writeChunk(file, "IHDR", header);
+
+    // Raw scanlines, each prefixed with filter type 0
+    std::vector<uint8_t> raw;
+    raw.reserve(static_cast<size_t>(bufferHeight) * (bufferWidth * 3 + 1));
+    for (int y = 0; y < bufferHeight; y++) {
+        raw.push_back(0);
+        const uint32_t* source = row(y);
+        for (int x = 0; x < bufferWidth; x++) {
+            raw.push_back(static_cast<uint8_t>(source[x] >> 16));
+            raw.push_back(static_cast<uint8_t>(source[x] >> 8));
+            raw.push_back(static_cast<uint8_t>(source[x]));
+        }
+    }
+
+    // zlib stream of stored blocks (max 65535 bytes each) plus Adler-32
+    std::vector<uint8_t> zlib = { 0x78, 0x01 };
+    size_t offset = 0;
+    do {
+        size_t blockSize = (std::min)(raw.size() - offset, static_cast<size_t>(65535));
+        bool last = offset + blockSize == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(blockSize));
+        zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+        zlib.push_back(static_cast<uint8_t>(~blockSize));
+        zlib.push_back(static_cast<uint8_t>(~blockSize >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    writeBigEndian(zlib, (b << 16) | a);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", {});
+
+    return static_cast<bool>(file);
+}
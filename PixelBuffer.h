@@ -0,0 +1,40 @@
+// PixelBuffer.h
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Pixel rectangle, right/bottom exclusive.
+struct PixelRect {
+    int left, top, right, bottom;
+    bool empty() const { return left >= right || top >= bottom; }
+};
+
+// Top-down 32-bit 0x00RRGGBB image. This is the same layout as a 32-bit BI_RGB
+// DIB, so the window can blit it directly, and it has no Windows dependency,
+// so it can be rendered and saved headlessly.
+class PixelBuffer {
+public:
+    PixelBuffer(int width, int height, uint32_t color = 0xFFFFFF);
+
+    static constexpr uint32_t rgb(uint8_t r, uint8_t g, uint8_t b) {
+        return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
+    }
+
+    int width() const { return bufferWidth; }
+    int height() const { return bufferHeight; }
+    const uint32_t* data() const { return pixels.data(); }
+    const uint32_t* row(int y) const { return pixels.data() + static_cast<size_t>(y) * bufferWidth; }
+    uint32_t pixel(int x, int y) const { return row(y)[x]; }
+
+    void fillRect(const PixelRect& rect, uint32_t color);
+
+    // Snapshots; return false if the file could not be written.
+    bool writePPM(const std::string& path) const;
+    bool writePNG(const std::string& path) const;
+
+private:
+    int bufferWidth;
+    int bufferHeight;
+    std::vector<uint32_t> pixels;
+};
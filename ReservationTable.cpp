@@ -0,0 +1,52 @@
+// ReservationTable.cpp
+#include "ReservationTable.h"
+#include <algorithm>
+
+ReservationTable::ReservationTable(const Grid& grid) : grid(grid) {
+}
+
+void ReservationTable::reservePath(const std::vector<Node>& path) {
+    if (path.empty()) {
+        return;
+    }
+
+    for (size_t t = 0; t < path.size(); t++) {
+        size_t cell = grid.index(path[t]);
+        uint32_t time = static_cast<uint32_t>(t);
+        vertices.insert(vertexKey(cell, time));
+        uint32_t& last = lastPassing[static_cast<uint32_t>(cell)];
+        last = (std::max)(last, time);
+        if (t + 1 < path.size()) {
+            edges.insert(edgeKey(cell, grid.index(path[t + 1]), time));
+        }
+    }
+    parkedFrom[static_cast<uint32_t>(grid.index(path.back()))] = static_cast<uint32_t>(path.size() - 1);
+}
+
+bool ReservationTable::isOccupied(const Node& cell, uint32_t time) const {
+    size_t index = grid.index(cell);
+    auto parked = parkedFrom.find(static_cast<uint32_t>(index));
+    if (parked != parkedFrom.end() && parked->second <= time) {
+        return true;
+    }
+    return vertices.count(vertexKey(index, time)) != 0;
+}
+
+bool ReservationTable::isMoveTaken(const Node& from, const Node& to, uint32_t time) const {
+    return edges.count(edgeKey(grid.index(from), grid.index(to), time)) != 0;
+}
+
+size_t ReservationTable::sizeBytes() const {
+    const size_t links = 2 * sizeof(void*);
+    return (vertices.size() + edges.size()) * (sizeof(uint64_t) + links)
+        + (parkedFrom.size() + lastPassing.size()) * (sizeof(std::pair<const uint32_t, uint32_t>) + links);
+}
+
+bool ReservationTable::canPark(const Node& cell, uint32_t time) const {
+    uint32_t index = static_cast<uint32_t>(grid.index(cell));
+    if (parkedFrom.count(index)) {
+        return false;
+    }
+    auto last = lastPassing.find(index);
+    return last == lastPassing.end() || last->second <= time;
+}
@@ -0,0 +1,45 @@
+// ReservationTable.h
+#pragma once
+#include "Grid.h"
+#include "Node.h"
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Space-time reservations for cooperative planning: which cells are occupied
+// at which time step, which moves are taken (so two agents cannot swap
+// cells), and where finished agents park for good. Keys are hashed
+// (time, cell) pairs, so memory grows with the planned paths rather than
+// with grid size x horizon.
+class ReservationTable {
+public:
+    explicit ReservationTable(const Grid& grid);
+
+    // Reserves a time-indexed path (path[t] is the cell at step t); the agent
+    // then stays on path.back() indefinitely.
+    void reservePath(const std::vector<Node>& path);
+
+    bool isOccupied(const Node& cell, uint32_t time) const;
+    // Someone moves from -> to between time and time + 1.
+    bool isMoveTaken(const Node& from, const Node& to, uint32_t time) const;
+    // Nobody needs the cell after the given time, so an agent may stop there.
+    bool canPark(const Node& cell, uint32_t time) const;
+
+    // Bytes held, counting each hash entry with its next link and bucket slot.
+    size_t sizeBytes() const;
+
+private:
+    const Grid& grid;
+    std::unordered_set<uint64_t> vertices;                // time * cells + cell
+    std::unordered_set<uint64_t> edges;                   // (time * cells + from) * cells + to
+    std::unordered_map<uint32_t, uint32_t> parkedFrom;    // cell -> first time step parked
+    std::unordered_map<uint32_t, uint32_t> lastPassing;   // cell -> latest time step reserved
+
+    uint64_t vertexKey(size_t cell, uint32_t time) const {
+        return static_cast<uint64_t>(time) * grid.cellCount() + cell;
+    }
+    uint64_t edgeKey(size_t from, size_t to, uint32_t time) const {
+        return vertexKey(from, time) * grid.cellCount() + to;
+    }
+};
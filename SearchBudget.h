@@ -0,0 +1,38 @@
+// SearchBudget.h
+#pragma once
+#include <chrono>
+#include <limits>
+#include <cstddef>
+
+// Caller-supplied limits on a search: a wall-clock deadline and/or a number
+// of node expansions. The clock is only sampled every CLOCK_CHECK_INTERVAL
+// expansions to keep the check off the hot path.
+struct SearchBudget {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t CLOCK_CHECK_INTERVAL = 256;
+
+    Clock::time_point deadline = (Clock::time_point::max)();
+    size_t maxExpansions = (std::numeric_limits<size_t>::max)();
+
+    static SearchBudget unlimited() {
+        return SearchBudget{};
+    }
+    static SearchBudget forDuration(std::chrono::microseconds duration) {
+        SearchBudget budget;
+        budget.deadline = Clock::now() + duration;
+        return budget;
+    }
+    static SearchBudget forExpansions(size_t expansions) {
+        SearchBudget budget;
+        budget.maxExpansions = expansions;
+        return budget;
+    }
+
+    // expansions counts the expansions made under this budget so far.
+    bool exhausted(size_t expansions) const {
+        if (expansions >= maxExpansions) return true;
+        if (expansions % CLOCK_CHECK_INTERVAL != 0) return false;
+        return deadline != (Clock::time_point::max)() && Clock::now() >= deadline;
+    }
+};
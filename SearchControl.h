@@ -0,0 +1,60 @@
+// SearchControl.h
+#pragma once
+#include "Node.h"
+#include "SearchEventLog.h"
+#include "SearchMemory.h"
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <cstddef>
+
+// Shared between a running search and whoever started it: the owner can cancel
+// from any thread, and the search streams newly expanded nodes back in batches
+// (on the search's own thread) so the caller can animate progress.
+class SearchControl {
+public:
+    using ProgressCallback = std::function<void(std::vector<Node>&&)>;
+
+    SearchControl() = default;
+    explicit SearchControl(ProgressCallback onProgress, size_t progressBatch = 256)
+        : onProgress(std::move(onProgress)), progressBatch(progressBatch) {
+    }
+
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    // Called by the search for every expanded node.
+    void nodeExpanded(const Node& node) {
+        if (!onProgress) return;
+        pending.push_back(node);
+        if (pending.size() >= progressBatch) {
+            flush();
+        }
+    }
+
+    // Optional event trace. The search reads this once when it starts and
+    // records into it only when set, so an unset log costs one branch per event.
+    void setEventLog(SearchEventLog* log) { events = log; }
+    SearchEventLog* eventLog() const { return events; }
+
+    // Per-query cap on the bytes the search's own structures may hold (see
+    // MemoryMeter). Past it the search stops with SearchStatus::MemoryLimit.
+    void setMemoryLimit(size_t bytes) { memoryCap = bytes; }
+    size_t memoryLimit() const { return memoryCap; }
+
+    // Hands any buffered nodes to the callback; the search calls this when it stops.
+    void flush() {
+        if (!onProgress || pending.empty()) return;
+        onProgress(std::move(pending));
+        pending = std::vector<Node>();
+        pending.reserve(progressBatch);
+    }
+
+private:
+    std::atomic<bool> cancelled{ false };
+    ProgressCallback onProgress;
+    size_t progressBatch = 256;
+    std::vector<Node> pending;
+    SearchEventLog* events = nullptr;
+    size_t memoryCap = MemoryMeter::UNLIMITED;
+};
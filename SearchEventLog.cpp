@@ -0,0 +1,183 @@
+// SearchEventLog.cpp
+#include "SearchEventLog.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace {
+    const char FILE_MAGIC[4] = { 'P', 'F', 'E', 'V' };
+    const uint32_t FILE_VERSION = 1;
+    const size_t MAX_EVENT_BYTES = 20;  // Two 10-byte varints
+    const size_t MIN_EVENT_BYTES = 2;   // Two 1-byte varints
+    const uint64_t BLOCK_HEADER_BYTES = 2 * sizeof(uint64_t);
+
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint64_t readVarint(const std::vector<uint8_t>& in, size_t& offset) {
+        uint64_t value = 0;
+        int shift = 0;
+        while (offset < in.size()) {
+            uint8_t byte = in[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        return value;
+    }
+
+    template <typename T>
+    void writeRaw(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readRaw(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+SearchEventLog::SearchEventLog(int gridWidth, size_t capacityBytes)
+    : gridWidth(gridWidth),
+    origin(std::chrono::steady_clock::now()),
+    blocks((std::max)(capacityBytes / BLOCK_SIZE, static_cast<size_t>(1))) {
+    for (Block& block : blocks) {
+        block.bytes.reserve(BLOCK_SIZE);
+    }
+}
+
+void SearchEventLog::append(SearchEventType type, uint32_t cell, uint64_t timeNs) {
+    Block* block = &blocks[(head + used - 1) % blocks.size()];
+    if (block->bytes.size() + MAX_EVENT_BYTES > BLOCK_SIZE || timeNs < previousTime) {
+        startNewBlock();
+        block = &blocks[(head + used - 1) % blocks.size()];
+    }
+
+    int64_t delta = static_cast<int64_t>(cell) - static_cast<int64_t>(previousCell);
+    uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+    writeVarint(block->bytes, (zigzag << 2) | static_cast<uint8_t>(type));
+    writeVarint(block->bytes, timeNs - previousTime);
+    block->events++;
+
+    previousCell = cell;
+    previousTime = timeNs;
+    recordedEvents++;
+}
+
+void SearchEventLog::startNewBlock() {
+    if (used == blocks.size()) {
+        // Ring is full: recycle the oldest block
+        droppedEventCount += blocks[head].events;
+        head = (head + 1) % blocks.size();
+        used--;
+    }
+    Block& block = blocks[(head + used) % blocks.size()];
+    block.bytes.clear();
+    block.events = 0;
+    used++;
+    previousCell = 0;
+    previousTime = 0;
+}
+
+std::vector<SearchEvent> SearchEventLog::decode() const {
+    std::vector<SearchEvent> events;
+    events.reserve(eventCount());
+
+    for (size_t i = 0; i < used; i++) {
+        const Block& block = blocks[(head + i) % blocks.size()];
+        uint32_t cell = 0;
+        uint64_t time = 0;
+        size_t offset = 0;
+        for (size_t e = 0; e < block.events; e++) {
+            uint64_t packed = readVarint(block.bytes, offset);
+            uint64_t zigzag = packed >> 2;
+            int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            cell = static_cast<uint32_t>(static_cast<int64_t>(cell) + delta);
+            time += readVarint(block.bytes, offset);
+
+            events.push_back(SearchEvent{
+                static_cast<SearchEventType>(packed & 3),
+                Node{ static_cast<int>(cell % gridWidth), static_cast<int>(cell / gridWidth) },
+                time
+            });
+        }
+    }
+    return events;
+}
+
+size_t SearchEventLog::sizeBytes() const {
+    size_t total = 0;
+    for (size_t i = 0; i < used; i++) {
+        total += blocks[(head + i) % blocks.size()].bytes.size();
+    }
+    return total;
+}
+
+// Layout: magic, version, grid width, block count, dropped events, then per
+// block its event count, byte count and bytes.
+bool SearchEventLog::saveToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    writeRaw(file, FILE_VERSION);
+    writeRaw(file, static_cast<int32_t>(gridWidth));
+    writeRaw(file, static_cast<uint64_t>(used));
+    writeRaw(file, static_cast<uint64_t>(droppedEventCount));
+    for (size_t i = 0; i < used; i++) {
+        const Block& block = blocks[(head + i) % blocks.size()];
+        writeRaw(file, static_cast<uint64_t>(block.events));
+        writeRaw(file, static_cast<uint64_t>(block.bytes.size()));
+        file.write(reinterpret_cast<const char*>(block.bytes.data()), block.bytes.size());
+    }
+    return static_cast<bool>(file);
+}
+
+// Counts come from the file, so each is checked against what the bytes left
+// can hold before anything is sized by it.
+std::optional<SearchEventLog> SearchEventLog::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    const std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+    char magic[4];
+    uint32_t version;
+    int32_t width;
+    uint64_t blockCount, dropped;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, FILE_MAGIC) ||
+        !readRaw(file, version) || version != FILE_VERSION ||
+        !readRaw(file, width) || width <= 0 ||
+        !readRaw(file, blockCount) || blockCount == 0 || !readRaw(file, dropped) ||
+        blockCount > static_cast<uint64_t>(fileSize - file.tellg()) / BLOCK_HEADER_BYTES) {
+        return std::nullopt;
+    }
+
+    // Blocks are added as they are read, so a damaged file fails on its bytes
+    // rather than on an allocation sized by its header
+    SearchEventLog log(width, BLOCK_SIZE);
+    log.blocks.clear();
+    log.droppedEventCount = static_cast<size_t>(dropped);
+    log.recordedEvents = log.droppedEventCount;
+    for (uint64_t i = 0; i < blockCount; i++) {
+        uint64_t events, bytes;
+        if (!readRaw(file, events) || !readRaw(file, bytes) || bytes > BLOCK_SIZE || events > bytes / MIN_EVENT_BYTES) {
+            return std::nullopt;
+        }
+        Block& block = log.blocks.emplace_back();
+        block.events = static_cast<size_t>(events);
+        block.bytes.resize(static_cast<size_t>(bytes));
+        if (!file.read(reinterpret_cast<char*>(block.bytes.data()), block.bytes.size())) {
+            return std::nullopt;
+        }
+        log.recordedEvents += block.events;
+    }
+    log.used = log.blocks.size();
+    // The deltas of the last loaded block are unknown to this log's clock, so
+    // any further events start a fresh block
+    log.previousTime = (std::numeric_limits<uint64_t>::max)();
+    return log;
+}
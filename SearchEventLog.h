@@ -0,0 +1,75 @@
+// SearchEventLog.h
+#pragma once
+#include "Node.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class SearchEventType : uint8_t {
+    Push = 0,   // Node discovered and put on the open list
+    Pop = 1,    // Node taken off the open list and expanded
+    Relax = 2,  // Open node's g improved
+    Jump = 3    // JPS jump point found from the node being expanded
+};
+
+struct SearchEvent {
+    SearchEventType type;
+    Node node;
+    uint64_t timeNs;  // Since the log was created
+};
+
+// Compact, ordered trace of a search for replay and offline analysis.
+//
+// Events are delta-encoded into fixed-size blocks preallocated up front: each
+// event is one varint of (zigzag(cell - previous cell) << 2 | type) and one
+// varint of the time since the previous event, typically 3-5 bytes in total.
+// Each block restarts the deltas so it decodes on its own; once every block
+// is full the oldest one is recycled, so the log acts as a ring buffer that
+// keeps the most recent events.
+class SearchEventLog {
+public:
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    explicit SearchEventLog(int gridWidth, size_t capacityBytes = 1 << 20);
+
+    // cell is row-major (y * width + x) whatever layout the searched Grid uses.
+    void record(SearchEventType type, uint32_t cell) {
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count());
+        append(type, cell, now);
+    }
+    void record(SearchEventType type, const Node& node) {
+        record(type, static_cast<uint32_t>(node.y) * gridWidth + node.x);
+    }
+
+    std::vector<SearchEvent> decode() const;
+
+    int width() const { return gridWidth; }
+    size_t eventCount() const { return recordedEvents - droppedEventCount; }
+    size_t droppedEvents() const { return droppedEventCount; }
+    size_t sizeBytes() const;
+
+    bool saveToFile(const std::string& path) const;
+    static std::optional<SearchEventLog> loadFromFile(const std::string& path);
+
+private:
+    struct Block {
+        std::vector<uint8_t> bytes;
+        size_t events = 0;
+    };
+
+    int gridWidth;
+    std::chrono::steady_clock::time_point origin;
+    std::vector<Block> blocks;   // Ring; oldest block at head
+    size_t head = 0;
+    size_t used = 1;             // Blocks in use, the newest at (head + used - 1)
+    uint32_t previousCell = 0;
+    uint64_t previousTime = 0;
+    size_t recordedEvents = 0;
+    size_t droppedEventCount = 0;
+
+    void append(SearchEventType type, uint32_t cell, uint64_t timeNs);
+    void startNewBlock();
+};
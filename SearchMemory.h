@@ -0,0 +1,64 @@
+// SearchMemory.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+// Bytes one query's search held, by what they were held for. Each field is
+// that structure's own peak; peakBytes is the peak of their sum, which is what
+// a query needs reserved (the structures need not peak at the same time).
+// Sizes count the elements held, not allocator overhead or growth slack.
+struct MemoryUsage {
+    size_t openList = 0;   // Priority queue, frontier or depth-first stack
+    size_t scores = 0;     // g scores, parents and other per-node bookkeeping
+    size_t explored = 0;   // Closed and explored sets, and other per-cell bit planes
+    size_t path = 0;       // The path returned
+    size_t peakBytes = 0;
+};
+
+// Tracks the current size of a search's structures against a per-query cap.
+// Searches check fixed per-cell arrays with fits() before allocating them, so
+// a query too big for its cap fails without touching the memory, and report
+// what grows (the open list, sparse score tables) once per expansion; the
+// peak can pass the cap by what one expansion adds.
+class MemoryMeter {
+public:
+    static constexpr size_t UNLIMITED = (std::numeric_limits<size_t>::max)();
+
+    explicit MemoryMeter(size_t limit = UNLIMITED) : limit(limit) {
+    }
+
+    // Whether structures about to be allocated fit, without recording them.
+    bool fits(size_t openList, size_t scores, size_t explored) {
+        over = over || openList + scores + explored > limit;
+        return !over;
+    }
+
+    // Sets the current sizes; false once their sum exceeds the limit.
+    bool update(size_t openList, size_t scores, size_t explored) {
+        current = openList + scores + explored;
+        usage.openList = (std::max)(usage.openList, openList);
+        usage.scores = (std::max)(usage.scores, scores);
+        usage.explored = (std::max)(usage.explored, explored);
+        usage.peakBytes = (std::max)(usage.peakBytes, current);
+        over = over || current > limit;
+        return !over;
+    }
+
+    // The path is the query's output, so it counts towards the peak (it is
+    // built while the search structures are still held) but never fails it.
+    void addPath(size_t bytes) {
+        usage.path = bytes;
+        usage.peakBytes = (std::max)(usage.peakBytes, current + bytes);
+    }
+
+    bool exceeded() const { return over; }
+    size_t bytesLimit() const { return limit; }
+    const MemoryUsage& result() const { return usage; }
+
+private:
+    size_t limit;
+    size_t current = 0;
+    bool over = false;
+    MemoryUsage usage;
+};
\ No newline at end of file
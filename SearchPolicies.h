@@ -0,0 +1,264 @@
+// SearchPolicies.h
+#pragma once
+#include "Constants.h"
+#include "Grid.h"
+#include "CellBitset.h"
+#include <queue>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+
+// Policy types plugged into BestFirstSearch. Everything here is resolved at
+// compile time, so each configuration compiles to its own inlined kernel.
+
+// ---------------------------------------------------------------------------
+// Movement models
+// ---------------------------------------------------------------------------
+
+// Directions 0-3 are cardinal, 4-7 diagonal. Without corner cutting a diagonal
+// step needs both adjacent cardinal cells to be free; with it, only one.
+// Excluded cells (Grid::exclude) are never stepped onto but count as free here.
+template <int Directions, bool AllowCornerCutting>
+struct GridMovement {
+    static_assert(Directions == 4 || Directions == 8, "Grid movement is 4- or 8-connected");
+
+    template <typename Visit>
+    static void forEachNeighbor(const Grid& grid, int x, int y, Visit&& visit) {
+        static constexpr int dx[] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+        static constexpr int dy[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+        for (int i = 0; i < Directions; i++) {
+            int newX = x + dx[i];
+            int newY = y + dy[i];
+
+            if (!grid.isEnterable(newX, newY)) {
+                continue;
+            }
+
+            if (i >= 4) { // Diagonal movement
+                bool horizontalFree = grid.isWalkable(newX, y);
+                bool verticalFree = grid.isWalkable(x, newY);
+                bool canMoveDiagonally = AllowCornerCutting
+                    ? (horizontalFree || verticalFree)
+                    : (horizontalFree && verticalFree);
+                if (!canMoveDiagonally) {
+                    continue;
+                }
+                visit(newX, newY, Constants::DIAGONAL_COST);
+            }
+            else {
+                visit(newX, newY, Constants::STRAIGHT_COST);
+            }
+        }
+    }
+};
+
+using FourConnected = GridMovement<4, false>;
+using EightConnected = GridMovement<8, false>;
+using EightConnectedCornerCutting = GridMovement<8, true>;
+
+// ---------------------------------------------------------------------------
+// Heuristics
+// ---------------------------------------------------------------------------
+
+struct OctileHeuristic {
+    int operator()(const Node& a, const Node& b) const {
+        // Octile distance heuristic - accounts for diagonal movement
+        int dx = std::abs(a.x - b.x);
+        int dy = std::abs(a.y - b.y);
+        return Constants::STRAIGHT_COST * (dx + dy) +
+            (Constants::DIAGONAL_COST - 2 * Constants::STRAIGHT_COST) * (std::min)(dx, dy);
+    }
+};
+
+struct ManhattanHeuristic {
+    int operator()(const Node& a, const Node& b) const {
+        return Constants::STRAIGHT_COST * (std::abs(a.x - b.x) + std::abs(a.y - b.y));
+    }
+};
+
+// Minimum of a base heuristic over several goals, for nearest-target
+// queries; the end point passed in is ignored. A minimum of consistent
+// heuristics is consistent, so the first goal expanded is the cheapest.
+template <typename Base>
+struct NearestGoalHeuristic {
+    std::vector<Node> goals;
+    Base base;
+
+    int operator()(const Node& a, const Node&) const {
+        int best = (std::numeric_limits<int>::max)();
+        for (const Node& goal : goals) {
+            best = (std::min)(best, base(a, goal));
+        }
+        return best;
+    }
+};
+
+// Inflates a base heuristic by a weight (Weighted A*). admissible() exposes
+// the uninflated estimate so the kernel can still compute a lower bound.
+template <typename BaseHeuristic>
+struct WeightedHeuristic {
+    double weight = 1.0;
+    BaseHeuristic base;
+
+    int operator()(const Node& a, const Node& b) const {
+        return static_cast<int>(weight * base(a, b));  // Truncating keeps h <= weight * h*
+    }
+    int admissible(const Node& a, const Node& b) const {
+        return base(a, b);
+    }
+};
+
+struct ZeroHeuristic {
+    int operator()(const Node&, const Node&) const {
+        return 0;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Tie-breaking (secondary key between entries with equal priority, lower first)
+// ---------------------------------------------------------------------------
+
+struct NoTieBreak {
+    int operator()(int, int, const Node&, const Node&, const Node&) const {
+        return 0;
+    }
+};
+
+// Prefers the deeper entry (larger g, so smaller h): A* then runs straight at
+// the goal instead of fanning out over every equal-f cell.
+struct HigherGTieBreak {
+    int operator()(int g, int, const Node&, const Node&, const Node&) const {
+        return -g;
+    }
+};
+
+// Prefers entries closest to the straight line from start to goal.
+struct CrossProductTieBreak {
+    int operator()(int, int, const Node& node, const Node& start, const Node& end) const {
+        int dx1 = node.x - end.x;
+        int dy1 = node.y - end.y;
+        int dx2 = start.x - end.x;
+        int dy2 = start.y - end.y;
+        return std::abs(dx1 * dy2 - dx2 * dy1);
+    }
+};
+
+// Insertion order within an f bucket: oldest first.
+struct FifoTieBreak {
+    int counter = 0;
+    int operator()(int, int, const Node&, const Node&, const Node&) {
+        return counter++;
+    }
+};
+
+// Insertion order within an f bucket: newest first.
+struct LifoTieBreak {
+    int counter = 0;
+    int operator()(int, int, const Node&, const Node&, const Node&) {
+        return -(counter++);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Open lists
+// ---------------------------------------------------------------------------
+
+struct OpenEntry {
+    int priority;
+    int tie;
+    uint32_t index;
+};
+
+struct CompareOpenEntry {
+    bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+        return a.priority > b.priority || (a.priority == b.priority && a.tie > b.tie);
+    }
+};
+
+// Binary heap with lazy deletion: stale duplicates are skipped by the kernel
+// when they surface, which is cheaper than a decrease-key structure on grids.
+class BinaryHeapOpenList {
+public:
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void push(const OpenEntry& entry) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), CompareOpenEntry{});
+    }
+    const OpenEntry& top() const { return heap.front(); }
+    OpenEntry pop() {
+        std::pop_heap(heap.begin(), heap.end(), CompareOpenEntry{});
+        OpenEntry top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+
+    // Visits the remaining entries in no particular order.
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        for (const OpenEntry& entry : heap) {
+            visit(entry);
+        }
+    }
+
+private:
+    std::vector<OpenEntry> heap;
+};
+
+// ---------------------------------------------------------------------------
+// Explored-node recording
+// ---------------------------------------------------------------------------
+
+// Records every node taken off the open list (A*, Dijkstra).
+struct RecordExpanded {
+    CellBitset explored;
+    explicit RecordExpanded(const Grid& grid) : explored(grid.width(), grid.height()) {}
+    void generated(const Node&) {}
+    void expanded(const Node& node) { explored.insert(node); }
+};
+
+// Records every node put on the open list (Greedy).
+struct RecordGenerated {
+    CellBitset explored;
+    explicit RecordGenerated(const Grid& grid) : explored(grid.width(), grid.height()) {}
+    void generated(const Node& node) { explored.insert(node); }
+    void expanded(const Node&) {}
+};
+
+// Records nothing; used when only the path is wanted.
+struct RecordNothing {
+    CellBitset explored;
+    explicit RecordNothing(const Grid&) {}
+    void generated(const Node&) {}
+    void expanded(const Node&) {}
+};
+
+// ---------------------------------------------------------------------------
+// Scoring
+// ---------------------------------------------------------------------------
+
+struct AStarScoring {
+    static int priority(int g, int h) { return g + h; }
+};
+
+struct GreedyScoring {
+    static int priority(int, int h) { return h; }
+};
+
+// Defaults shared by the search configurations; each finder overrides what differs.
+struct DefaultSearchConfig {
+    using Movement = EightConnected;
+    using Heuristic = OctileHeuristic;
+    using TieBreak = NoTieBreak;
+    using OpenList = BinaryHeapOpenList;
+    using Recorder = RecordExpanded;
+    using Scoring = AStarScoring;
+
+    // Re-open closed nodes whose g improves. Required once the heuristic is
+    // inflated for the open list to keep an optimal-path node, so the kernel
+    // can report a lower bound on the optimal cost (SearchResult::lowerBound).
+    static constexpr bool reopenClosed = false;
+};
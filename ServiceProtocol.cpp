@@ -0,0 +1,201 @@
+// ServiceProtocol.cpp
+#include "ServiceProtocol.h"
+#include <algorithm>
+#include <limits>
+
+MessageWriter::MessageWriter(MessageType type) {
+    bytes.push_back(static_cast<uint8_t>(type));
+}
+
+MessageWriter& MessageWriter::writeString(const std::string& text) {
+    size_t length = (std::min)(text.size(), static_cast<size_t>((std::numeric_limits<uint16_t>::max)()));
+    write(static_cast<uint16_t>(length));
+    bytes.insert(bytes.end(), text.begin(), text.begin() + length);
+    return *this;
+}
+
+MessageWriter& MessageWriter::writeBytes(const std::vector<uint8_t>& data) {
+    bytes.insert(bytes.end(), data.begin(), data.end());
+    return *this;
+}
+
+std::vector<uint8_t> MessageWriter::frame() const {
+    std::vector<uint8_t> framed(sizeof(uint32_t) + bytes.size());
+    uint32_t length = static_cast<uint32_t>(bytes.size());
+    std::memcpy(framed.data(), &length, sizeof(length));
+    std::memcpy(framed.data() + sizeof(length), bytes.data(), bytes.size());
+    return framed;
+}
+
+bool MessageReader::readString(std::string& text) {
+    uint16_t length;
+    if (!read(length) || bytes.size() - offset < length) {
+        return ok = false;
+    }
+    text.assign(reinterpret_cast<const char*>(bytes.data() + offset), length);
+    offset += length;
+    return true;
+}
+
+bool MessageReader::readBytes(std::vector<uint8_t>& data, size_t count) {
+    if (!ok || bytes.size() - offset < count) {
+        return ok = false;
+    }
+    data.assign(bytes.begin() + offset, bytes.begin() + offset + count);
+    offset += count;
+    return true;
+}
+
+std::vector<uint8_t> encodeLoadMap(const std::vector<std::vector<bool>>& walls) {
+    uint16_t height = static_cast<uint16_t>(walls.size());
+    uint16_t width = static_cast<uint16_t>(walls.empty() ? 0 : walls[0].size());
+    std::vector<uint8_t> bits((static_cast<size_t>(width) * height + 7) / 8, 0);
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            if (walls[y][x]) {
+                size_t bit = y * width + x;
+                bits[bit / 8] |= static_cast<uint8_t>(1 << (bit % 8));
+            }
+        }
+    }
+    return MessageWriter(MessageType::LoadMap).write(width).write(height).writeBytes(bits).frame();
+}
+
+std::optional<std::vector<std::vector<bool>>> decodeLoadMap(MessageReader& reader) {
+    uint16_t width, height;
+    std::vector<uint8_t> bits;
+    if (!reader.read(width) || !reader.read(height) ||
+        !reader.readBytes(bits, (static_cast<size_t>(width) * height + 7) / 8) || !reader.atEnd()) {
+        return std::nullopt;
+    }
+
+    std::vector<std::vector<bool>> walls(height, std::vector<bool>(width, false));
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            size_t bit = y * width + x;
+            walls[y][x] = (bits[bit / 8] >> (bit % 8)) & 1;
+        }
+    }
+    return walls;
+}
+
+std::vector<uint8_t> encodeQuery(const QueryRequest& request) {
+    return MessageWriter(MessageType::Query)
+        .write(request.requestId)
+        .write(request.mapId)
+        .writeString(request.algorithm)
+        .write(static_cast<int16_t>(request.start.x))
+        .write(static_cast<int16_t>(request.start.y))
+        .write(static_cast<int16_t>(request.end.x))
+        .write(static_cast<int16_t>(request.end.y))
+        .write(request.tieBreak)
+        .write(request.memoryLimit)
+        .frame();
+}
+
+std::optional<QueryRequest> decodeQuery(MessageReader& reader) {
+    QueryRequest request;
+    int16_t startX, startY, endX, endY;
+    reader.read(request.requestId);
+    reader.read(request.mapId);
+    reader.readString(request.algorithm);
+    reader.read(startX);
+    reader.read(startY);
+    reader.read(endX);
+    reader.read(endY);
+    reader.read(request.tieBreak);
+    if (reader.good() && !reader.atEnd()) {
+        reader.read(request.memoryLimit);  // Absent from clients older than the field
+    }
+    if (!reader.atEnd()) {
+        return std::nullopt;
+    }
+    request.start = Node{ startX, startY };
+    request.end = Node{ endX, endY };
+    return request;
+}
+
+std::vector<uint8_t> encodeQueryDone(const QueryReply& reply) {
+    MessageWriter writer(MessageType::QueryDone);
+    writer.write(reply.requestId)
+        .write(static_cast<uint8_t>(reply.status))
+        .write(static_cast<int32_t>(reply.cost))
+        .write(reply.nodesExpanded)
+        .write(reply.peakBytes)
+        .write(reply.searchMs)
+        .write(static_cast<uint32_t>(reply.path.size()));
+    for (const Node& node : reply.path) {
+        writer.write(static_cast<int16_t>(node.x)).write(static_cast<int16_t>(node.y));
+    }
+    return writer.frame();
+}
+
+std::optional<QueryReply> decodeQueryDone(MessageReader& reader) {
+    QueryReply reply;
+    uint8_t status;
+    int32_t cost;
+    uint32_t pathLength = 0;
+    reader.read(reply.requestId);
+    reader.read(status);
+    reader.read(cost);
+    reader.read(reply.nodesExpanded);
+    reader.read(reply.peakBytes);
+    reader.read(reply.searchMs);
+    reader.read(pathLength);
+    for (uint32_t i = 0; i < pathLength && reader.good(); i++) {
+        int16_t x = 0, y = 0;
+        reader.read(x);
+        reader.read(y);
+        reply.path.push_back(Node{ x, y });
+    }
+    if (!reader.atEnd()) {
+        return std::nullopt;
+    }
+    reply.status = static_cast<SearchStatus>(status);
+    reply.cost = cost;
+    return reply;
+}
+
+std::vector<uint8_t> encodeStatsReport(const ServiceStats& stats) {
+    MessageWriter writer(MessageType::StatsReport);
+    writer.write(stats.queueDepth).write(stats.batches).write(static_cast<uint32_t>(stats.algorithms.size()));
+    for (const AlgorithmStats& algorithm : stats.algorithms) {
+        writer.writeString(algorithm.algorithm)
+            .write(algorithm.queries)
+            .write(algorithm.meanMs)
+            .write(algorithm.p50Ms)
+            .write(algorithm.p99Ms)
+            .write(algorithm.maxMs)
+            .write(algorithm.meanPeakBytes)
+            .write(algorithm.maxPeakBytes);
+    }
+    return writer.frame();
+}
+
+std::optional<ServiceStats> decodeStatsReport(MessageReader& reader) {
+    ServiceStats stats;
+    uint32_t count = 0;
+    reader.read(stats.queueDepth);
+    reader.read(stats.batches);
+    reader.read(count);
+    for (uint32_t i = 0; i < count && reader.good(); i++) {
+        AlgorithmStats algorithm;
+        reader.readString(algorithm.algorithm);
+        reader.read(algorithm.queries);
+        reader.read(algorithm.meanMs);
+        reader.read(algorithm.p50Ms);
+        reader.read(algorithm.p99Ms);
+        reader.read(algorithm.maxMs);
+        reader.read(algorithm.meanPeakBytes);
+        reader.read(algorithm.maxPeakBytes);
+        stats.algorithms.push_back(std::move(algorithm));
+    }
+    if (!reader.atEnd()) {
+        return std::nullopt;
+    }
+    return stats;
+}
+
+std::vector<uint8_t> encodeError(uint32_t requestId, const std::string& message) {
+    return MessageWriter(MessageType::Error).write(requestId).writeString(message).frame();
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+// ServiceProtocol.h
+#pragma once
+#include "Node.h"
+#include "BestFirstSearch.h"
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Wire format of the pathfinding daemon (PathfindingDaemon.cpp). Every message
+// travels as a frame: a uint32 payload length, then the payload, whose first
+// byte is the MessageType. Values are written raw in host byte order, as in
+// the event log files; the socket is local, so both ends share it.
+//
+// Queries carry a client-chosen request id and may be pipelined: replies
+// come back as each query finishes, not in request order.
+enum class MessageType : uint8_t {
+    LoadMap = 1,        // u16 width, u16 height, wall bits row-major (bit i of byte i / 8)
+    Query = 2,          // u32 request id, u32 map id, string algorithm, i16 start x/y, i16 end x/y, u8 tie-break[, u64 memory limit]
+    Stats = 3,          // Empty
+    UnloadMap = 4,      // u32 map id
+    MapLoaded = 0x81,   // u32 map id
+    QueryDone = 0x82,   // u32 request id, u8 status, i32 cost, u64 nodes expanded, u64 peak bytes, f64 search ms, u32 n, n x (i16 x, i16 y)
+    StatsReport = 0x83, // u64 queue depth, u64 batches, u32 n, n x AlgorithmStats
+    MapUnloaded = 0x84, // u32 map id
+    Error = 0xFF        // u32 request id (0 if not about a query), string message
+};
+
+// Strings are a u16 length followed by the bytes.
+class MessageWriter {
+public:
+    explicit MessageWriter(MessageType type);
+
+    template <typename T>
+    MessageWriter& write(T value) {
+        size_t offset = bytes.size();
+        bytes.resize(offset + sizeof(T));
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+        return *this;
+    }
+    MessageWriter& writeString(const std::string& text);
+    MessageWriter& writeBytes(const std::vector<uint8_t>& data);
+
+    // Length prefix plus payload, ready to send.
+    std::vector<uint8_t> frame() const;
+
+private:
+    std::vector<uint8_t> bytes;
+};
+
+// Reads a payload (without the length prefix). Every read fails once the
+// payload runs out, so a malformed message can be checked once at the end.
+class MessageReader {
+public:
+    explicit MessageReader(std::vector<uint8_t> payload) : bytes(std::move(payload)) {
+    }
+
+    std::optional<MessageType> type() const {
+        if (bytes.empty()) return std::nullopt;
+        return static_cast<MessageType>(bytes[0]);
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        if (!ok || bytes.size() - offset < sizeof(T)) {
+            return ok = false;
+        }
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+    bool readString(std::string& text);
+    bool readBytes(std::vector<uint8_t>& data, size_t count);
+    bool good() const { return ok; }
+    bool atEnd() const { return ok && offset == bytes.size(); }
+
+private:
+    std::vector<uint8_t> bytes;
+    size_t offset = 1;  // Past the type byte
+    bool ok = true;
+};
+
+struct AlgorithmStats {
+    std::string algorithm;
+    uint64_t queries = 0;
+    double meanMs = 0.0;  // Latency from arrival to reply, including the wait for a worker
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double meanPeakBytes = 0.0;  // Peak search memory per query (MemoryUsage::peakBytes)
+    uint64_t maxPeakBytes = 0;
+};
+
+struct ServiceStats {
+    uint64_t queueDepth = 0;  // Queries waiting for a worker
+    uint64_t batches = 0;     // Worker tasks run so far
+    std::vector<AlgorithmStats> algorithms;
+};
+
+struct QueryRequest {
+    uint32_t requestId = 0;
+    uint32_t mapId = 0;
+    std::string algorithm;
+    Node start{ 0, 0 };
+    Node end{ 0, 0 };
+    uint8_t tieBreak = 0;  // TieBreakPolicy, A* only
+    // Bytes the search may hold, 0 for the service's own limit. Queries over
+    // it are answered by Compact A* within the same limit (see PathQuery).
+    uint64_t memoryLimit = 0;
+};
+
+struct QueryReply {
+    uint32_t requestId = 0;
+    SearchStatus status = SearchStatus::NoPath;
+    int cost = -1;
+    uint64_t nodesExpanded = 0;
+    uint64_t peakBytes = 0;
+    double searchMs = 0.0;
+    std::vector<Node> path;
+};
+
+std::vector<uint8_t> encodeLoadMap(const std::vector<std::vector<bool>>& walls);
+std::optional<std::vector<std::vector<bool>>> decodeLoadMap(MessageReader& reader);
+
+std::vector<uint8_t> encodeQuery(const QueryRequest& request);
+std::optional<QueryRequest> decodeQuery(MessageReader& reader);
+
+std::vector<uint8_t> encodeQueryDone(const QueryReply& reply);
+std::optional<QueryReply> decodeQueryDone(MessageReader& reader);
+
+std::vector<uint8_t> encodeStatsReport(const ServiceStats& stats);
+std::optional<ServiceStats> decodeStatsReport(MessageReader& reader);
+
+std::vector<uint8_t> encodeError(uint32_t requestId, const std::string& message);
\ No newline at end of file
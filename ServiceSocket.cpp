@@ -0,0 +1,203 @@
+// ServiceSocket.cpp
+#include "ServiceSocket.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+using SocketHandle = SOCKET;
+const SocketHandle NO_SOCKET = INVALID_SOCKET;
+const int SEND_FLAGS = 0;
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using SocketHandle = int;
+const SocketHandle NO_SOCKET = -1;
+const int SEND_FLAGS = MSG_NOSIGNAL;  // A client that hung up is an error, not a SIGPIPE
+#endif
+
+namespace {
+    void initializeSockets() {
+#ifdef _WIN32
+        static std::once_flag once;
+        std::call_once(once, [] {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        });
+#endif
+    }
+
+    void closeHandle(SocketHandle socket) {
+#ifdef _WIN32
+        closesocket(socket);
+#else
+        ::close(socket);
+#endif
+    }
+
+    int lastSocketError() {
+#ifdef _WIN32
+        return WSAGetLastError();
+#else
+        return errno;
+#endif
+    }
+
+    bool makeAddress(const std::string& path, sockaddr_un& address) {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    LocalSocket::AcceptError::Kind classifyAcceptError(int code) {
+        using Error = LocalSocket::AcceptError;
+#ifdef _WIN32
+        switch (code) {
+        case WSAEINTR:
+        case WSAECONNRESET:  // Winsock's report of a connection aborted before accept
+            return Error::Retry;
+        case WSAEMFILE:
+        case WSAENOBUFS:
+            return Error::OutOfResources;
+        }
+#else
+        switch (code) {
+        case EINTR:
+        case ECONNABORTED:
+        case EPROTO:  // Linux passes on some network errors of the pending connection
+            return Error::Retry;
+        case EMFILE:
+        case ENFILE:
+        case ENOBUFS:
+        case ENOMEM:
+            return Error::OutOfResources;
+        }
+#endif
+        return Error::Fatal;
+    }
+}
+
+std::optional<LocalSocket> LocalSocket::listen(const std::string& path) {
+    initializeSockets();
+    sockaddr_un address;
+    if (!makeAddress(path, address)) {
+        return std::nullopt;
+    }
+
+    SocketHandle socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket == NO_SOCKET) {
+        return std::nullopt;
+    }
+    std::remove(path.c_str());  // Left behind by a previous run
+    if (::bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(socket, SOMAXCONN) != 0) {
+        closeHandle(socket);
+        return std::nullopt;
+    }
+    return LocalSocket(static_cast<intptr_t>(socket));
+}
+
+std::optional<LocalSocket> LocalSocket::connect(const std::string& path) {
+    initializeSockets();
+    sockaddr_un address;
+    if (!makeAddress(path, address)) {
+        return std::nullopt;
+    }
+
+    SocketHandle socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket == NO_SOCKET) {
+        return std::nullopt;
+    }
+    if (::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        closeHandle(socket);
+        return std::nullopt;
+    }
+    return LocalSocket(static_cast<intptr_t>(socket));
+}
+
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept : handle(other.handle) {
+    other.handle = static_cast<intptr_t>(NO_SOCKET);
+}
+
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        other.handle = static_cast<intptr_t>(NO_SOCKET);
+    }
+    return *this;
+}
+
+LocalSocket::~LocalSocket() {
+    close();
+}
+
+void LocalSocket::close() {
+    if (handle != static_cast<intptr_t>(NO_SOCKET)) {
+        closeHandle(static_cast<SocketHandle>(handle));
+        handle = static_cast<intptr_t>(NO_SOCKET);
+    }
+}
+
+std::optional<LocalSocket> LocalSocket::accept(AcceptError* error) const {
+    SocketHandle client = ::accept(static_cast<SocketHandle>(handle), nullptr, nullptr);
+    if (client == NO_SOCKET) {
+        if (error) {
+            error->code = lastSocketError();
+            error->kind = classifyAcceptError(error->code);
+        }
+        return std::nullopt;
+    }
+    return LocalSocket(static_cast<intptr_t>(client));
+}
+
+bool LocalSocket::sendAll(const uint8_t* data, size_t size) const {
+    while (size > 0) {
+        int chunk = static_cast<int>((std::min)(size, size_t{ 1 } << 30));
+        auto sent = ::send(static_cast<SocketHandle>(handle), reinterpret_cast<const char*>(data), chunk, SEND_FLAGS);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool LocalSocket::receiveAll(uint8_t* data, size_t size) const {
+    while (size > 0) {
+        int chunk = static_cast<int>((std::min)(size, size_t{ 1 } << 30));
+        auto received = ::recv(static_cast<SocketHandle>(handle), reinterpret_cast<char*>(data), chunk, 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool LocalSocket::sendFrame(const std::vector<uint8_t>& frame) const {
+    return sendAll(frame.data(), frame.size());
+}
+
+std::optional<std::vector<uint8_t>> LocalSocket::receiveFrame() const {
+    uint32_t length;
+    if (!receiveAll(reinterpret_cast<uint8_t*>(&length), sizeof(length)) || length == 0 || length > MAX_FRAME_BYTES) {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> payload(length);
+    if (!receiveAll(payload.data(), payload.size())) {
+        return std::nullopt;
+    }
+    return payload;
+}
\ No newline at end of file
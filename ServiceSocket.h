@@ -0,0 +1,52 @@
+// ServiceSocket.h
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Stream socket on a Unix domain socket path, carrying ServiceProtocol frames.
+// AF_UNIX is native on POSIX; on Windows it needs Windows 10 1803 or later
+// (Winsock with afunix.h). Move-only; closes the socket when destroyed.
+class LocalSocket {
+public:
+    // Frames larger than this are treated as a broken stream.
+    static constexpr uint32_t MAX_FRAME_BYTES = 64u << 20;
+
+    // Removes a stale socket file at path before binding.
+    static std::optional<LocalSocket> listen(const std::string& path);
+    static std::optional<LocalSocket> connect(const std::string& path);
+
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator=(LocalSocket&& other) noexcept;
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator=(const LocalSocket&) = delete;
+    ~LocalSocket();
+
+    // Why accept() returned no client.
+    struct AcceptError {
+        enum Kind {
+            Retry,           // Interrupted, or the client gave up before it was accepted
+            OutOfResources,  // Descriptor or buffer limit; retry once some are freed
+            Fatal            // The listener itself is broken
+        } kind = Fatal;
+        int code = 0;        // errno, or WSAGetLastError() on Windows
+    };
+
+    // Blocks until a client connects. On failure fills in error, if given.
+    std::optional<LocalSocket> accept(AcceptError* error = nullptr) const;
+
+    // frame is a complete frame (length prefix included), as built by MessageWriter.
+    bool sendFrame(const std::vector<uint8_t>& frame) const;
+    // The payload of the next frame; nothing once the peer closes or on error.
+    std::optional<std::vector<uint8_t>> receiveFrame() const;
+
+private:
+    intptr_t handle;
+
+    explicit LocalSocket(intptr_t handle) : handle(handle) {
+    }
+    bool sendAll(const uint8_t* data, size_t size) const;
+    bool receiveAll(uint8_t* data, size_t size) const;
+    void close();
+};
\ No newline at end of file
@@ -0,0 +1,508 @@
+// StatsStore.cpp
+#include "StatsStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+#include <unistd.h>
+#endif
+
+// PATHFINDING_BUILD_ID is passed unquoted (see BuildId.targets)
+#define STRINGIZE_TOKENS(x) #x
+#define STRINGIZE(x) STRINGIZE_TOKENS(x)
+
+namespace {
+    const uint32_t CHUNK_MAGIC = 0x54534650;  // "PFST"
+    const size_t CHUNK_HEADER_BYTES = 12;     // Magic, row count, payload bytes
+
+    void putBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void putValue(std::vector<uint8_t>& out, T value) {
+        putBytes(out, &value, sizeof(T));
+    }
+
+    template <typename T>
+    void putColumn(std::vector<uint8_t>& out, StatsColumn id, const std::vector<T>& values, size_t first, size_t count) {
+        putValue(out, static_cast<uint8_t>(id));
+        putValue(out, static_cast<uint8_t>(sizeof(T)));
+        putBytes(out, values.data() + first, count * sizeof(T));
+    }
+
+    // Bounds-checked cursor over a chunk payload.
+    struct Reader {
+        const uint8_t* data;
+        size_t size;
+        size_t offset = 0;
+
+        bool take(void* into, size_t bytes) {
+            if (size - offset < bytes) return false;
+            std::memcpy(into, data + offset, bytes);
+            offset += bytes;
+            return true;
+        }
+        template <typename T>
+        bool value(T& into) {
+            return take(&into, sizeof(T));
+        }
+    };
+
+    // Offset of the first CHUNK_MAGIC in [from, end) of the file, or end if
+    // there is none.
+    uint64_t findMagic(std::ifstream& file, uint64_t from, uint64_t end) {
+        const uint8_t* magic = reinterpret_cast<const uint8_t*>(&CHUNK_MAGIC);  // Little-endian, as written
+        std::vector<uint8_t> block(65536);
+        while (end - from >= sizeof(CHUNK_MAGIC)) {
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(from));
+            file.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>((std::min)(block.size(), static_cast<size_t>(end - from))));
+            const size_t got = static_cast<size_t>(file.gcount());
+            if (got < sizeof(CHUNK_MAGIC)) break;
+            auto found = std::search(block.begin(), block.begin() + got, magic, magic + sizeof(CHUNK_MAGIC));
+            if (found != block.begin() + got) {
+                return from + static_cast<uint64_t>(found - block.begin());
+            }
+            from += got - (sizeof(CHUNK_MAGIC) - 1);  // A magic may straddle two blocks
+        }
+        return end;
+    }
+
+    // Whether the following bytes at the file position can come after a whole
+    // chunk: none, the next chunk's magic, or the first bytes of a magic cut
+    // off by a tear, then nothing or another magic.
+    bool atChunkBoundary(std::ifstream& file, uint64_t following) {
+        if (following == 0) return true;
+        const uint8_t* magic = reinterpret_cast<const uint8_t*>(&CHUNK_MAGIC);
+        uint8_t next[2 * sizeof(CHUNK_MAGIC) - 1];
+        const size_t count = static_cast<size_t>((std::min)(following, static_cast<uint64_t>(sizeof(next))));
+        file.read(reinterpret_cast<char*>(next), static_cast<std::streamsize>(count));
+        if (file.gcount() != static_cast<std::streamsize>(count)) return false;
+        for (size_t torn = 0; torn < sizeof(CHUNK_MAGIC) && std::equal(next, next + torn, magic); torn++) {
+            if (following == torn) return true;
+            if (count >= torn + sizeof(CHUNK_MAGIC) && std::equal(next + torn, next + torn + sizeof(CHUNK_MAGIC), magic)) return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    void readColumn(std::vector<T>& into, const uint8_t* data, size_t rows) {
+        size_t first = into.size();
+        into.resize(first + rows);
+        std::memcpy(into.data() + first, data, rows * sizeof(T));
+    }
+
+    // String columns are stored as chunk dictionary indices
+    void readStringColumn(std::vector<uint32_t>& into, const uint8_t* data, size_t rows, const std::vector<uint32_t>& remap) {
+        size_t first = into.size();
+        readColumn(into, data, rows);
+        for (size_t i = first; i < into.size(); i++) {
+            into[i] = into[i] < remap.size() ? remap[into[i]] : remap.at(0);
+        }
+    }
+
+    int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    uint16_t toCoordinate(int value) {
+        return value >= 0 && value < StatsTable::NO_COORDINATE ? static_cast<uint16_t>(value) : StatsTable::NO_COORDINATE;
+    }
+}
+
+void StatsTable::truncate(size_t rows) {
+    timestampUs.resize((std::min)(timestampUs.size(), rows));
+    run.resize((std::min)(run.size(), rows));
+    build.resize((std::min)(build.size(), rows));
+    machine.resize((std::min)(machine.size(), rows));
+    algorithm.resize((std::min)(algorithm.size(), rows));
+    mapId.resize((std::min)(mapId.size(), rows));
+    mapWidth.resize((std::min)(mapWidth.size(), rows));
+    mapHeight.resize((std::min)(mapHeight.size(), rows));
+    startX.resize((std::min)(startX.size(), rows));
+    startY.resize((std::min)(startY.size(), rows));
+    endX.resize((std::min)(endX.size(), rows));
+    endY.resize((std::min)(endY.size(), rows));
+    pathLength.resize((std::min)(pathLength.size(), rows));
+    nodesExpanded.resize((std::min)(nodesExpanded.size(), rows));
+    timeMs.resize((std::min)(timeMs.size(), rows));
+    peakBytes.resize((std::min)(peakBytes.size(), rows));
+}
+
+uint32_t StatsTable::intern(const std::string& text) {
+    auto [it, added] = stringIndex.try_emplace(text, static_cast<uint32_t>(strings.size()));
+    if (added) {
+        strings.push_back(text);
+    }
+    return it->second;
+}
+
+void StatsTable::addRow(int64_t timestamp, uint32_t runIndex, uint32_t buildIndex, uint32_t machineIndex,
+    uint32_t algorithmIndex, uint64_t map, int width, int height, const Node& start, const Node& end,
+    size_t length, size_t expanded, double ms, uint64_t peak) {
+    timestampUs.push_back(timestamp);
+    run.push_back(runIndex);
+    build.push_back(buildIndex);
+    machine.push_back(machineIndex);
+    algorithm.push_back(algorithmIndex);
+    mapId.push_back(map);
+    mapWidth.push_back(toCoordinate(width));
+    mapHeight.push_back(toCoordinate(height));
+    startX.push_back(toCoordinate(start.x));
+    startY.push_back(toCoordinate(start.y));
+    endX.push_back(toCoordinate(end.x));
+    endY.push_back(toCoordinate(end.y));
+    pathLength.push_back(static_cast<uint32_t>(length));
+    nodesExpanded.push_back(static_cast<uint32_t>(expanded));
+    timeMs.push_back(ms);
+    peakBytes.push_back(peak);
+}
+
+bool StatsTable::appendToFile(const std::string& path) const {
+    if (!trimTornChunk(path)) {
+        return false;
+    }
+    std::vector<uint8_t> payload;
+    for (size_t first = 0; first < size(); first += CHUNK_ROWS) {
+        if (!appendChunk(path, payload, first, (std::min)(CHUNK_ROWS, size() - first))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Encodes rows first..first + count - 1 into one chunk and appends it with a
+// single write, so a crash can at worst cut the last chunk short.
+bool StatsTable::appendChunk(const std::string& path, std::vector<uint8_t>& payload, size_t first, size_t count) const {
+    payload.clear();
+    putValue(payload, CHUNK_MAGIC);
+    putValue(payload, static_cast<uint32_t>(count));
+    putValue(payload, uint32_t{ 0 });  // Payload size, filled in below
+
+    putValue(payload, static_cast<uint32_t>(strings.size()));
+    for (const std::string& text : strings) {
+        putValue(payload, static_cast<uint32_t>(text.size()));
+        putBytes(payload, text.data(), text.size());
+    }
+
+    putValue(payload, uint8_t{ 16 });  // Column count
+    putColumn(payload, StatsColumn::Timestamp, timestampUs, first, count);
+    putColumn(payload, StatsColumn::Run, run, first, count);
+    putColumn(payload, StatsColumn::Build, build, first, count);
+    putColumn(payload, StatsColumn::Machine, machine, first, count);
+    putColumn(payload, StatsColumn::Algorithm, algorithm, first, count);
+    putColumn(payload, StatsColumn::MapId, mapId, first, count);
+    putColumn(payload, StatsColumn::MapWidth, mapWidth, first, count);
+    putColumn(payload, StatsColumn::MapHeight, mapHeight, first, count);
+    putColumn(payload, StatsColumn::StartX, startX, first, count);
+    putColumn(payload, StatsColumn::StartY, startY, first, count);
+    putColumn(payload, StatsColumn::EndX, endX, first, count);
+    putColumn(payload, StatsColumn::EndY, endY, first, count);
+    putColumn(payload, StatsColumn::PathLength, pathLength, first, count);
+    putColumn(payload, StatsColumn::NodesExpanded, nodesExpanded, first, count);
+    putColumn(payload, StatsColumn::TimeMs, timeMs, first, count);
+    putColumn(payload, StatsColumn::PeakBytes, peakBytes, first, count);
+
+    uint32_t payloadBytes = static_cast<uint32_t>(payload.size() - CHUNK_HEADER_BYTES);
+    std::memcpy(payload.data() + 8, &payloadBytes, sizeof(payloadBytes));
+
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    return file.good();
+}
+
+// Chunks are written with one write each, so a crash can only tear the last
+// one. Cutting it off before appending keeps new chunks right after whole
+// ones. A bad magic before the end is damage rather than a tear; that is left
+// for loadFile to skip.
+bool StatsTable::trimTornChunk(const std::string& path) {
+    std::error_code error;
+    const uint64_t fileSize = std::filesystem::file_size(path, error);
+    if (error) {
+        return true;  // No file yet
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    uint64_t chunkStart = 0;
+    while (chunkStart < fileSize) {
+        uint32_t header[3];
+        file.seekg(static_cast<std::streamoff>(chunkStart));
+        file.read(reinterpret_cast<char*>(header), CHUNK_HEADER_BYTES);
+        if (file.gcount() == static_cast<std::streamsize>(CHUNK_HEADER_BYTES) && header[0] != CHUNK_MAGIC) {
+            return true;
+        }
+        if (file.gcount() != static_cast<std::streamsize>(CHUNK_HEADER_BYTES)
+            || fileSize - chunkStart - CHUNK_HEADER_BYTES < header[2]) {
+            file.close();
+            std::filesystem::resize_file(path, chunkStart, error);
+            return !error;
+        }
+        chunkStart += CHUNK_HEADER_BYTES + header[2];
+    }
+    return true;
+}
+
+bool StatsTable::loadFile(const std::string& path) {
+    std::error_code error;
+    const uint64_t fileSize = std::filesystem::file_size(path, error);
+    std::ifstream file(path, std::ios::binary);
+    if (error || !file) {
+        return false;
+    }
+
+    // A damaged chunk is skipped by scanning for the next magic, so one torn
+    // or corrupt chunk does not hide the ones appended after it
+    bool intact = true;
+    std::vector<uint8_t> payload;
+    uint64_t chunkStart = 0;
+    while (chunkStart < fileSize) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(chunkStart));
+        if (readChunk(file, fileSize - chunkStart, payload)) {
+            chunkStart += CHUNK_HEADER_BYTES + payload.size();
+            continue;
+        }
+        intact = false;
+        chunkStart = findMagic(file, chunkStart + 1, fileSize);
+    }
+    return intact;
+}
+
+// Reads the chunk at the file position, at most available bytes long. Adds
+// its rows only if the whole chunk is well formed.
+bool StatsTable::readChunk(std::ifstream& file, uint64_t available, std::vector<uint8_t>& payload) {
+    uint32_t header[3];
+    file.read(reinterpret_cast<char*>(header), CHUNK_HEADER_BYTES);
+    if (file.gcount() != static_cast<std::streamsize>(CHUNK_HEADER_BYTES) || header[0] != CHUNK_MAGIC
+        || available - CHUNK_HEADER_BYTES < header[2]) {
+        return false;
+    }
+    const size_t rows = header[1];
+    payload.resize(header[2]);
+    file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    if (file.gcount() != static_cast<std::streamsize>(payload.size())) {
+        return false;
+    }
+    // A chunk ends at the end of the file or at the next chunk's magic; a torn
+    // one's payload size runs into whatever was appended after the tear
+    if (!atChunkBoundary(file, available - CHUNK_HEADER_BYTES - header[2])) {
+        return false;
+    }
+
+    Reader reader{ payload.data(), payload.size() };
+    uint32_t stringCount = 0;
+    if (!reader.value(stringCount)) return false;
+    std::vector<uint32_t> remap;
+    for (uint32_t i = 0; i < stringCount; i++) {
+        uint32_t length = 0;
+        if (!reader.value(length) || reader.size - reader.offset < length) return false;
+        remap.push_back(intern(std::string(reinterpret_cast<const char*>(reader.data + reader.offset), length)));
+        reader.offset += length;
+    }
+    if (remap.empty()) {
+        remap.push_back(intern(""));
+    }
+
+    const size_t base = size();
+    uint8_t columnCount = 0;
+    if (!reader.value(columnCount)) return false;
+    // A chunk that fails part way drops the columns read so far, so every
+    // column keeps the same length
+    for (uint8_t c = 0; c < columnCount; c++) {
+        uint8_t id = 0;
+        uint8_t elementSize = 0;
+        if (!reader.value(id) || !reader.value(elementSize)) {
+            truncate(base);
+            return false;
+        }
+        const size_t bytes = rows * elementSize;
+        if (reader.size - reader.offset < bytes) {
+            truncate(base);
+            return false;
+        }
+        const uint8_t* data = reader.data + reader.offset;
+        reader.offset += bytes;
+
+        // A column seen twice, or with an unexpected width, is skipped like an unknown one
+        auto fresh = [&](const auto& column, size_t expectedSize) {
+            return column.size() == base && elementSize == expectedSize;
+        };
+        switch (static_cast<StatsColumn>(id)) {
+        case StatsColumn::Timestamp: if (fresh(timestampUs, 8)) readColumn(timestampUs, data, rows); break;
+        case StatsColumn::Run: if (fresh(run, 4)) readStringColumn(run, data, rows, remap); break;
+        case StatsColumn::Build: if (fresh(build, 4)) readStringColumn(build, data, rows, remap); break;
+        case StatsColumn::Machine: if (fresh(machine, 4)) readStringColumn(machine, data, rows, remap); break;
+        case StatsColumn::Algorithm: if (fresh(algorithm, 4)) readStringColumn(algorithm, data, rows, remap); break;
+        case StatsColumn::MapId: if (fresh(mapId, 8)) readColumn(mapId, data, rows); break;
+        case StatsColumn::MapWidth: if (fresh(mapWidth, 2)) readColumn(mapWidth, data, rows); break;
+        case StatsColumn::MapHeight: if (fresh(mapHeight, 2)) readColumn(mapHeight, data, rows); break;
+        case StatsColumn::StartX: if (fresh(startX, 2)) readColumn(startX, data, rows); break;
+        case StatsColumn::StartY: if (fresh(startY, 2)) readColumn(startY, data, rows); break;
+        case StatsColumn::EndX: if (fresh(endX, 2)) readColumn(endX, data, rows); break;
+        case StatsColumn::EndY: if (fresh(endY, 2)) readColumn(endY, data, rows); break;
+        case StatsColumn::PathLength: if (fresh(pathLength, 4)) readColumn(pathLength, data, rows); break;
+        case StatsColumn::NodesExpanded: if (fresh(nodesExpanded, 4)) readColumn(nodesExpanded, data, rows); break;
+        case StatsColumn::TimeMs: if (fresh(timeMs, 8)) readColumn(timeMs, data, rows); break;
+        case StatsColumn::PeakBytes: if (fresh(peakBytes, 8)) readColumn(peakBytes, data, rows); break;
+        default: break;
+        }
+    }
+    if (reader.offset != reader.size) {
+        truncate(base);
+        return false;  // Bytes left over: not the chunk the header describes
+    }
+
+    // Columns this chunk lacks get defaults, keeping every column the same length
+    const size_t total = base + rows;
+    const uint32_t none = intern("");
+    timestampUs.resize(total, 0);
+    run.resize(total, none);
+    build.resize(total, none);
+    machine.resize(total, none);
+    algorithm.resize(total, none);
+    mapId.resize(total, 0);
+    mapWidth.resize(total, 0);
+    mapHeight.resize(total, 0);
+    startX.resize(total, NO_COORDINATE);
+    startY.resize(total, NO_COORDINATE);
+    endX.resize(total, NO_COORDINATE);
+    endY.resize(total, NO_COORDINATE);
+    pathLength.resize(total, 0);
+    nodesExpanded.resize(total, 0);
+    timeMs.resize(total, 0.0);
+    peakBytes.resize(total, 0);
+    return true;
+}
+
+long long StatsTable::importCsv(const std::string& path, const std::string& runLabel) {
+    std::ifstream file(path);
+    if (!file) {
+        return -1;
+    }
+
+    const uint32_t runIndex = intern(runLabel);
+    const uint32_t none = intern("");
+    const Node unknown{ -1, -1 };
+    long long imported = 0;
+    std::string line;
+    std::getline(file, line);  // MapID,Algorithm,PathLength,NodesVisited,TimeMs
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        // The algorithm sits between the first comma and the last three
+        size_t firstComma = line.find(',');
+        size_t timeComma = line.rfind(',');
+        size_t nodesComma = timeComma == std::string::npos ? std::string::npos : line.rfind(',', timeComma - 1);
+        size_t lengthComma = nodesComma == std::string::npos ? std::string::npos : line.rfind(',', nodesComma - 1);
+        if (firstComma == std::string::npos || lengthComma == std::string::npos || lengthComma <= firstComma) {
+            continue;
+        }
+        try {
+            uint64_t map = std::stoull(line.substr(0, firstComma), nullptr, 16);
+            std::string name = line.substr(firstComma + 1, lengthComma - firstComma - 1);
+            size_t length = std::stoull(line.substr(lengthComma + 1, nodesComma - lengthComma - 1));
+            size_t expanded = std::stoull(line.substr(nodesComma + 1, timeComma - nodesComma - 1));
+            double ms = std::stod(line.substr(timeComma + 1));
+            addRow(0, runIndex, none, none, intern(name), map, 0, 0, unknown, unknown, length, expanded, ms);
+            imported++;
+        }
+        catch (const std::exception&) {
+            // Not a data row
+        }
+    }
+    return imported;
+}
+
+StatsWriter::StatsWriter(std::string path, std::string runLabel, size_t chunkRows)
+    : path(std::move(path)),
+    run(std::move(runLabel)),
+    chunkRows((std::max)(chunkRows, size_t{ 1 })),
+    runIndex(buffer.intern(run)),
+    buildIndex(buffer.intern(buildId())),
+    machineIndex(buffer.intern(machineName())) {
+}
+
+StatsWriter::~StatsWriter() {
+    flush();
+}
+
+void StatsWriter::append(const std::string& algorithm, uint64_t mapId, int mapWidth, int mapHeight,
+    const Node& start, const Node& end, size_t pathLength, size_t nodesExpanded, double timeMs,
+    uint64_t peakBytes) {
+    buffer.addRow(nowUs(), runIndex, buildIndex, machineIndex, buffer.intern(algorithm), mapId,
+        mapWidth, mapHeight, start, end, pathLength, nodesExpanded, timeMs, peakBytes);
+    if (buffer.size() >= chunkRows) {
+        flush();
+    }
+}
+
+bool StatsWriter::flush() {
+    if (buffer.empty()) {
+        return true;
+    }
+    bool written = buffer.appendToFile(path);
+    buffer.clear();
+    return written;
+}
+
+std::string StatsWriter::defaultRunLabel() {
+    static const std::string label = [] {
+        std::time_t now = std::time(nullptr);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        std::stringstream ss;
+        ss << std::put_time(&local, "%Y-%m-%d %H:%M:%S");
+        return ss.str();
+    }();
+    return label;
+}
+
+std::string StatsWriter::buildId() {
+#ifdef PATHFINDING_BUILD_ID
+    std::string revision = STRINGIZE(PATHFINDING_BUILD_ID);
+#else
+    std::string revision;
+#endif
+    if (revision.empty()) {
+        revision = "unknown";
+    }
+#ifdef _DEBUG
+    return revision + " Debug";
+#else
+    return revision + " Release";
+#endif
+}
+
+std::string StatsWriter::machineName() {
+#ifdef _WIN32
+    char* name = nullptr;
+    size_t length = 0;
+    std::string machine;
+    if (_dupenv_s(&name, &length, "COMPUTERNAME") == 0 && name) {
+        machine = name;
+    }
+    std::free(name);
+#else
+    char name[256] = {};
+    std::string machine = gethostname(name, sizeof(name) - 1) == 0 ? name : "";
+#endif
+    return machine.empty() ? "unknown" : machine;
+}
\ No newline at end of file
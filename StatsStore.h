@@ -0,0 +1,139 @@
+// StatsStore.h
+#pragma once
+#include "Node.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+enum class StatsColumn : uint8_t {
+    Timestamp = 1,      // int64, microseconds since the Unix epoch
+    Run = 2,            // uint32 string index
+    Build = 3,          // uint32 string index
+    Machine = 4,        // uint32 string index
+    Algorithm = 5,      // uint32 string index
+    MapId = 6,          // uint64
+    MapWidth = 7,       // uint16
+    MapHeight = 8,      // uint16
+    StartX = 9,         // uint16, NO_COORDINATE when unknown
+    StartY = 10,
+    EndX = 11,
+    EndY = 12,
+    PathLength = 13,    // uint32
+    NodesExpanded = 14, // uint32
+    TimeMs = 15,        // double
+    PeakBytes = 16      // uint64, MemoryUsage::peakBytes, 0 when not measured
+};
+
+// Query results held column by column: each field is one contiguous vector,
+// so aggregating a column over millions of rows is a linear scan, and the
+// strings (run, build, machine, algorithm) are interned into one dictionary.
+//
+// On disk a stats file is a sequence of self-contained chunks, each a header
+// (magic, row count, payload size), the string dictionary and then the
+// columns, tagged with their StatsColumn and element size, as raw
+// little-endian arrays. Appending only ever writes a new chunk at the end of
+// the file, after cutting off a last chunk torn by a crash; reading takes one
+// read per chunk and one copy per column. Readers skip columns they do not
+// know and default the ones a chunk lacks, and skip a damaged chunk by
+// scanning for the next chunk header, so the chunks after it still load.
+class StatsTable {
+public:
+    static constexpr uint16_t NO_COORDINATE = 0xFFFF;
+    static constexpr size_t CHUNK_ROWS = 65536;
+
+    std::vector<std::string> strings;
+    std::vector<int64_t> timestampUs;
+    std::vector<uint32_t> run;
+    std::vector<uint32_t> build;
+    std::vector<uint32_t> machine;
+    std::vector<uint32_t> algorithm;
+    std::vector<uint64_t> mapId;
+    std::vector<uint16_t> mapWidth;
+    std::vector<uint16_t> mapHeight;
+    std::vector<uint16_t> startX;
+    std::vector<uint16_t> startY;
+    std::vector<uint16_t> endX;
+    std::vector<uint16_t> endY;
+    std::vector<uint32_t> pathLength;
+    std::vector<uint32_t> nodesExpanded;
+    std::vector<double> timeMs;
+    std::vector<uint64_t> peakBytes;
+
+    size_t size() const { return timeMs.size(); }
+    bool empty() const { return timeMs.empty(); }
+    // Removes the rows; interned strings keep their indices.
+    void clear() { truncate(0); }
+    // Removes the rows from the given one on.
+    void truncate(size_t rows);
+
+    // Index of text in strings, added if new.
+    uint32_t intern(const std::string& text);
+    const std::string& text(uint32_t index) const { return strings[index]; }
+
+    // Appends a row; start or end outside 0..65534 is stored as unknown.
+    void addRow(int64_t timestamp, uint32_t runIndex, uint32_t buildIndex, uint32_t machineIndex,
+        uint32_t algorithmIndex, uint64_t map, int width, int height, const Node& start, const Node& end,
+        size_t length, size_t expanded, double ms, uint64_t peak = 0);
+
+    // Appends the rows of a stats file. False if it cannot be opened or is
+    // damaged; the rows of every intact chunk are kept, and none of a
+    // damaged chunk's.
+    bool loadFile(const std::string& path);
+
+    // Appends the rows of a pathfinding_stats.csv from before the binary
+    // store, as run runLabel with no timestamp, build, machine or endpoints.
+    // Returns the number of rows read, or -1 if the file cannot be opened.
+    long long importCsv(const std::string& path, const std::string& runLabel);
+
+    // Appends every row to path as new chunks.
+    bool appendToFile(const std::string& path) const;
+
+private:
+    std::unordered_map<std::string, uint32_t> stringIndex;
+
+    // Cuts a last chunk torn by a crash off the end of path; true if there
+    // was nothing to cut or it was cut.
+    static bool trimTornChunk(const std::string& path);
+    bool readChunk(std::ifstream& file, uint64_t available, std::vector<uint8_t>& payload);
+    bool appendChunk(const std::string& path, std::vector<uint8_t>& payload, size_t first, size_t count) const;
+};
+
+// Appends query results to a stats file, stamping each row with the time and
+// with this process's run, build and machine. Rows are buffered and written
+// as one chunk every chunkRows rows, on flush() and on destruction.
+class StatsWriter {
+public:
+    explicit StatsWriter(std::string path, std::string runLabel = defaultRunLabel(), size_t chunkRows = StatsTable::CHUNK_ROWS);
+    ~StatsWriter();
+
+    StatsWriter(const StatsWriter&) = delete;
+    StatsWriter& operator=(const StatsWriter&) = delete;
+
+    void append(const std::string& algorithm, uint64_t mapId, int mapWidth, int mapHeight,
+        const Node& start, const Node& end, size_t pathLength, size_t nodesExpanded, double timeMs,
+        uint64_t peakBytes = 0);
+    bool flush();
+
+    const std::string& runLabel() const { return run; }
+
+    // Local start time of the process, e.g. "2024-05-01 14:03:12".
+    static std::string defaultRunLabel();
+    // Source revision from the build (PATHFINDING_BUILD_ID, set by
+    // BuildId.targets) plus configuration, e.g. "3f141c6-dirty Release";
+    // "unknown Release" when built without it.
+    static std::string buildId();
+    // Host name, "unknown" if it cannot be read.
+    static std::string machineName();
+
+private:
+    std::string path;
+    std::string run;
+    size_t chunkRows;
+    StatsTable buffer;
+    uint32_t runIndex;
+    uint32_t buildIndex;
+    uint32_t machineIndex;
+};
\ No newline at end of file
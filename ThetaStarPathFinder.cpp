@@ -0,0 +1,147 @@
+// ThetaStarPathFinder.cpp
+#include "ThetaStarPathFinder.h"
+#include "LineOfSight.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+std::pair<std::vector<Node>, CellBitset> ThetaStarPathFinder::findPath(
+    const std::vector<std::vector<bool>>& walls,
+    const Node& start,
+    const Node& end
+) {
+    AnyAngleResult result = search(Grid(walls), start, end);
+    return { std::move(result.search.path), std::move(result.search.explored) };
+}
+
+AnyAngleResult ThetaStarPathFinder::search(
+    const Grid& grid,
+    const Node& start,
+    const Node& end,
+    bool lazy,
+    SearchControl* control
+) {
+    const size_t cellCount = grid.cellCount();
+    AnyAngleResult result;
+
+    // The line-of-sight wall masks count with the closed and explored bit sets
+    const size_t scoreBytes = cellCount * (sizeof(double) + sizeof(uint32_t));
+    const size_t exploredBytes = 2 * CellBitset::bytesFor(cellCount) + LineOfSight::bytesFor(grid);
+    MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    if (!meter.fits(0, scoreBytes, exploredBytes)) {
+        result.search.status = SearchStatus::MemoryLimit;
+        return result;
+    }
+    meter.update(0, scoreBytes, exploredBytes);
+
+    const double infinity = (std::numeric_limits<double>::max)();
+    std::vector<double> gScore(cellCount, infinity);
+    std::vector<uint32_t> parent(cellCount, NO_PARENT);
+    CellBitset closed(cellCount);
+    using Entry = std::pair<double, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openSet;
+    LineOfSight lineOfSight(grid);
+    RecordExpanded recorder(grid);
+    SearchEventLog* events = control ? control->eventLog() : nullptr;
+
+    auto distance = [&](uint32_t a, uint32_t b) {
+        Node from = grid.node(a);
+        Node to = grid.node(b);
+        return Constants::STRAIGHT_COST * std::hypot(from.x - to.x, from.y - to.y);
+    };
+    auto visible = [&](uint32_t a, uint32_t b) {
+        return lineOfSight.visible(grid.node(a), grid.node(b));
+    };
+
+    const uint32_t startIndex = static_cast<uint32_t>(grid.index(start));
+    const uint32_t endIndex = static_cast<uint32_t>(grid.index(end));
+
+    gScore[startIndex] = 0.0;
+    parent[startIndex] = startIndex;
+    openSet.push({ distance(startIndex, endIndex), startIndex });
+    if (events) events->record(SearchEventType::Push, start);
+
+    while (!openSet.empty()) {
+        uint32_t current = openSet.top().second;
+        openSet.pop();
+        if (closed.test(current)) continue;  // Stale duplicate
+
+        Node currentNode = grid.node(current);
+        if (lazy && parent[current] != current && !visible(parent[current], current)) {
+            // Assumed line of sight was blocked: take the best expanded neighbor
+            gScore[current] = infinity;
+            EightConnected::forEachNeighbor(grid, currentNode.x, currentNode.y, [&](int x, int y, int) {
+                uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+                if (!closed.test(neighbor)) return;
+                double viaNeighbor = gScore[neighbor] + distance(neighbor, current);
+                if (viaNeighbor < gScore[current]) {
+                    gScore[current] = viaNeighbor;
+                    parent[current] = neighbor;
+                }
+            });
+            // The corrected g is higher, so other nodes may now come first
+            openSet.push({ gScore[current] + distance(current, endIndex), current });
+            continue;
+        }
+
+        closed.set(current);
+        recorder.expanded(currentNode);
+        result.search.nodesExpanded++;
+        if (events) events->record(SearchEventType::Pop, currentNode);
+
+        if (control) {
+            if (control->isCancelled()) {
+                result.search.status = SearchStatus::Cancelled;
+                break;
+            }
+            control->nodeExpanded(currentNode);
+        }
+
+        if (current == endIndex) {
+            for (uint32_t at = endIndex; ; at = parent[at]) {
+                Node node = grid.node(at);
+                result.waypoints.push_back(Waypoint{ static_cast<uint16_t>(node.x), static_cast<uint16_t>(node.y) });
+                if (parent[at] == at) break;
+            }
+            std::reverse(result.waypoints.begin(), result.waypoints.end());
+            result.search.status = SearchStatus::Found;
+            result.search.path = rasterizeWaypoints(result.waypoints);
+            result.search.cost = static_cast<int>(std::lround(gScore[endIndex]));
+            meter.addPath(result.search.path.size() * sizeof(Node) + result.waypoints.size() * sizeof(Waypoint));
+            break;
+        }
+
+        const uint32_t grandparent = parent[current];
+        EightConnected::forEachNeighbor(grid, currentNode.x, currentNode.y, [&](int x, int y, int) {
+            uint32_t neighbor = static_cast<uint32_t>(grid.index(x, y));
+            if (closed.test(neighbor)) return;
+
+            // Path 2 (straight from the grandparent) when allowed, else path 1
+            uint32_t from = (lazy || visible(grandparent, neighbor)) ? grandparent : current;
+            double tentativeGScore = gScore[from] + distance(from, neighbor);
+            if (tentativeGScore < gScore[neighbor]) {
+                if (events) {
+                    events->record(gScore[neighbor] == infinity ? SearchEventType::Push : SearchEventType::Relax, Node{ x, y });
+                }
+                gScore[neighbor] = tentativeGScore;
+                parent[neighbor] = from;
+                openSet.push({ tentativeGScore + distance(neighbor, endIndex), neighbor });
+            }
+        });
+
+        if (!meter.update(openSet.size() * sizeof(Entry), scoreBytes, exploredBytes)) {
+            result.search.status = SearchStatus::MemoryLimit;
+            break;
+        }
+    }
+
+    if (control) {
+        control->flush();
+    }
+    result.search.explored = std::move(recorder.explored);
+    result.search.memory = meter.result();
+    return result;
+}
@@ -0,0 +1,37 @@
+// ThetaStarPathFinder.h
+#pragma once
+#include "Node.h"
+#include "BestFirstSearch.h"
+#include "CellBitset.h"
+#include "SearchControl.h"
+#include "PathSmoothing.h"
+#include <vector>
+
+struct AnyAngleResult {
+    SearchResult search;     // path: cells along the segments; cost: rounded Euclidean length
+    WaypointPath waypoints;  // Any-angle vertices from start to end
+};
+
+// Any-angle search on the 8-connected grid with Euclidean costs. A node's
+// parent may be any earlier node it has line of sight to, so paths come out
+// as a few straight segments instead of a staircase.
+//
+// Theta* checks line of sight for every generated neighbor; Lazy Theta*
+// assumes it and only checks once per expanded node, falling back to the best
+// expanded neighbor when the assumption was wrong.
+class ThetaStarPathFinder {
+public:
+    static std::pair<std::vector<Node>, CellBitset> findPath(
+        const std::vector<std::vector<bool>>& walls,
+        const Node& start,
+        const Node& end
+    );
+
+    static AnyAngleResult search(
+        const Grid& grid,
+        const Node& start,
+        const Node& end,
+        bool lazy = true,
+        SearchControl* control = nullptr
+    );
+};
@@ -0,0 +1,323 @@
+// WavefrontSearch.cpp
+#include "WavefrontSearch.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    // Moves every cell one column right (x -> x + 1); lower is the word to the left.
+    uint64_t shiftRight(uint64_t word, uint64_t lower) {
+        return (word << 1) | (lower >> 63);
+    }
+
+    // Moves every cell one column left (x -> x - 1); higher is the word to the right.
+    uint64_t shiftLeft(uint64_t word, uint64_t higher) {
+        return (word >> 1) | (higher << 63);
+    }
+}
+
+WavefrontSearch::WavefrontSearch(const Grid& grid, WavefrontMoves moves)
+    : gridWidth(grid.width()),
+    gridHeight(grid.height()),
+    wordsPerRow((static_cast<size_t>(grid.width()) + 63) / 64),
+    stride(wordsPerRow + 2),
+    moveSet(moves),
+    open(stride * (grid.height() + 2), 0),
+    visited(open.size(), 0),
+    frontier(open.size(), 0),
+    next(open.size(), 0),
+    frontierSpans(grid.height(), { 1, 0 }),
+    nextSpans(grid.height(), { 1, 0 }) {
+    for (int y = 0; y < gridHeight; y++) {
+        for (int x = 0; x < gridWidth; x++) {
+            if (grid.isWalkable(x, y)) {
+                open[wordIndex(x, y)] |= uint64_t{ 1 } << (x % 64);
+            }
+        }
+    }
+}
+
+size_t WavefrontSearch::fixedBytes(const Grid& grid) {
+    size_t stride = (static_cast<size_t>(grid.width()) + 63) / 64 + 2;
+    return 4 * stride * (grid.height() + 2) * sizeof(uint64_t) + 2 * grid.height() * sizeof(std::pair<int, int>);
+}
+
+bool WavefrontSearch::run(const Node& start, const Node& goal, SearchControl* control) {
+    return expand(start, &goal, control);
+}
+
+void WavefrontSearch::flood(const Node& start, SearchControl* control) {
+    expand(start, nullptr, control);
+}
+
+bool WavefrontSearch::isOpen(int x, int y) const {
+    return x >= 0 && x < gridWidth && y >= 0 && y < gridHeight
+        && ((open[wordIndex(x, y)] >> (x % 64)) & 1);
+}
+
+// The given word of the layer after the current frontier.
+uint64_t WavefrontSearch::nextWord(size_t word) const {
+    const uint64_t* here = &frontier[word];
+    const uint64_t* free = &open[word];
+    uint64_t reach = shiftRight(here[0], here[-1]) | shiftLeft(here[0], here[1]);
+
+    for (ptrdiff_t row : { -static_cast<ptrdiff_t>(stride), static_cast<ptrdiff_t>(stride) }) {
+        const uint64_t* source = here + row;
+        reach |= source[0];
+
+        if (moveSet == WavefrontMoves::Eight) {
+            // A diagonal step from (x, y') to (x +- 1, y) needs (x, y) and
+            // (x +- 1, y') free: mask the source by this row before shifting,
+            // the target by the source row after.
+            uint64_t through = source[0] & free[0];
+            uint64_t diagonal = shiftRight(through, source[-1] & free[-1])
+                | shiftLeft(through, source[1] & free[1]);
+            reach |= diagonal & free[row];
+        }
+    }
+    return reach & free[0] & ~visited[word];
+}
+
+bool WavefrontSearch::expand(const Node& start, const Node* goal, SearchControl* control) {
+    std::fill(visited.begin(), visited.end(), 0);
+    std::fill(frontier.begin(), frontier.end(), 0);
+    std::fill(frontierSpans.begin(), frontierSpans.end(), std::pair{ 1, 0 });
+    layerWords.clear();
+    layerStart.assign(1, 0);
+
+    // frontier, next and their spans are the open list, the stored layers
+    // the scores and the free-cell and visited planes the explored set
+    const size_t planeBytes = open.size() * sizeof(uint64_t);
+    const size_t frontierBytes = 2 * planeBytes + 2 * frontierSpans.size() * sizeof(std::pair<int, int>);
+    const size_t exploredBytes = 2 * planeBytes;
+    MemoryMeter meter(control ? control->memoryLimit() : MemoryMeter::UNLIMITED);
+    auto withinLimit = [&] {
+        memoryExceeded = !meter.update(frontierBytes,
+            layerWords.size() * sizeof(LayerWord) + layerStart.size() * sizeof(size_t), exploredBytes);
+        memory = meter.result();
+        return !memoryExceeded;
+    };
+
+    if (!withinLimit() || !isOpen(start.x, start.y)) {
+        return false;
+    }
+
+    uint32_t startWord = static_cast<uint32_t>(wordIndex(start.x, start.y));
+    uint64_t startBit = uint64_t{ 1 } << (start.x % 64);
+    frontier[startWord] = startBit;
+    visited[startWord] = startBit;
+    frontierSpans[start.y] = { start.x / 64, start.x / 64 };
+    layerWords.push_back({ startWord, startBit });
+    layerStart.push_back(layerWords.size());
+    if (control) {
+        control->nodeExpanded(start);
+    }
+
+    const int lastWord = static_cast<int>(wordsPerRow) - 1;
+    bool goalReached = goal && *goal == start;
+    int low = start.y;
+    int high = start.y;
+    while (!goalReached) {
+        if (control && control->isCancelled()) {
+            break;
+        }
+
+        // The next layer lies within one row and one word of the frontier
+        int from = (std::max)(low - 1, 0);
+        int to = (std::min)(high + 1, gridHeight - 1);
+        int nextLow = gridHeight;
+        int nextHigh = -1;
+        for (int y = from; y <= to; y++) {
+            int first = lastWord + 1;
+            int last = -1;
+            for (int row = (std::max)(y - 1, low); row <= (std::min)(y + 1, high); row++) {
+                if (frontierSpans[row].first <= frontierSpans[row].second) {
+                    first = (std::min)(first, frontierSpans[row].first);
+                    last = (std::max)(last, frontierSpans[row].second);
+                }
+            }
+            if (first > last) {
+                continue;
+            }
+
+            std::pair<int, int> span{ 1, 0 };
+            for (int w = (std::max)(first - 1, 0); w <= (std::min)(last + 1, lastWord); w++) {
+                size_t word = wordIndex(w * 64, y);
+                uint64_t bits = nextWord(word);
+                if (bits) {
+                    next[word] = bits;
+                    span = span.first > span.second ? std::pair{ w, w } : std::pair{ span.first, w };
+                }
+            }
+            nextSpans[y] = span;
+            if (span.first <= span.second) {
+                nextLow = (std::min)(nextLow, y);
+                nextHigh = y;
+            }
+        }
+
+        // Keep both buffers zero outside their spans
+        for (int y = low; y <= high; y++) {
+            auto [first, last] = frontierSpans[y];
+            if (first <= last) {
+                std::fill(frontier.begin() + wordIndex(first * 64, y), frontier.begin() + wordIndex(last * 64, y) + 1, 0);
+            }
+            frontierSpans[y] = { 1, 0 };
+        }
+        std::swap(frontier, next);
+        std::swap(frontierSpans, nextSpans);
+        if (nextHigh < 0) {
+            break;  // Everything reachable has been reached
+        }
+        low = nextLow;
+        high = nextHigh;
+
+        for (int y = low; y <= high; y++) {
+            auto [first, last] = frontierSpans[y];
+            for (int w = first; w <= last; w++) {
+                size_t word = wordIndex(w * 64, y);
+                uint64_t bits = frontier[word];
+                if (!bits) {
+                    continue;
+                }
+                visited[word] |= bits;
+                layerWords.push_back({ static_cast<uint32_t>(word), bits });
+
+                if (control) {
+                    for (uint64_t rest = bits; rest; rest &= rest - 1) {
+                        control->nodeExpanded(cellOf(static_cast<uint32_t>(word), std::countr_zero(rest)));
+                    }
+                }
+            }
+        }
+        layerStart.push_back(layerWords.size());
+
+        if (goal && isOpen(goal->x, goal->y)) {
+            goalReached = (frontier[wordIndex(goal->x, goal->y)] >> (goal->x % 64)) & 1;
+        }
+        if (!withinLimit()) {
+            goalReached = false;
+            break;
+        }
+    }
+
+    if (control) {
+        control->flush();
+    }
+    return goalReached;
+}
+
+bool WavefrontSearch::inLayer(size_t layer, int x, int y) const {
+    if (!isOpen(x, y)) {
+        return false;
+    }
+
+    uint32_t word = static_cast<uint32_t>(wordIndex(x, y));
+    auto first = layerWords.begin() + layerStart[layer];
+    auto last = layerWords.begin() + layerStart[layer + 1];
+    auto it = std::lower_bound(first, last, word, [](const LayerWord& entry, uint32_t value) {
+        return entry.word < value;
+    });
+    return it != last && it->word == word && ((it->bits >> (x % 64)) & 1);
+}
+
+int WavefrontSearch::hopDistance(const Node& node) const {
+    for (size_t layer = 0; layer < layerCount(); layer++) {
+        if (inLayer(layer, node.x, node.y)) {
+            return static_cast<int>(layer);
+        }
+    }
+    return -1;
+}
+
+std::vector<int> WavefrontSearch::hopDistances() const {
+    std::vector<int> distances(static_cast<size_t>(gridWidth) * gridHeight, -1);
+    for (size_t layer = 0; layer < layerCount(); layer++) {
+        for (size_t i = layerStart[layer]; i < layerStart[layer + 1]; i++) {
+            for (uint64_t rest = layerWords[i].bits; rest; rest &= rest - 1) {
+                Node cell = cellOf(layerWords[i].word, std::countr_zero(rest));
+                distances[static_cast<size_t>(cell.y) * gridWidth + cell.x] = static_cast<int>(layer);
+            }
+        }
+    }
+    return distances;
+}
+
+CellBitset WavefrontSearch::reached() const {
+    CellBitset cells(gridWidth, gridHeight);
+    for (const LayerWord& entry : layerWords) {
+        for (uint64_t rest = entry.bits; rest; rest &= rest - 1) {
+            cells.set(cellOf(entry.word, std::countr_zero(rest)));
+        }
+    }
+    return cells;
+}
+
+std::vector<Node> WavefrontSearch::pathTo(const Node& node) const {
+    int distance = hopDistance(node);
+    if (distance < 0) {
+        return {};
+    }
+
+    static const int directions[8][2] = {
+        {0, -1}, {1, 0}, {0, 1}, {-1, 0},   // Cardinal first, for straighter paths
+        {1, -1}, {1, 1}, {-1, 1}, {-1, -1}
+    };
+    int directionCount = moveSet == WavefrontMoves::Eight ? 8 : 4;
+
+    std::vector<Node> path{ node };
+    Node current = node;
+    for (int layer = distance - 1; layer >= 0; layer--) {
+        for (int i = 0; i < directionCount; i++) {
+            int dx = directions[i][0];
+            int dy = directions[i][1];
+            if (dx != 0 && dy != 0 && !(isOpen(current.x + dx, current.y) && isOpen(current.x, current.y + dy))) {
+                continue;  // Would cut a corner
+            }
+            if (inLayer(layer, current.x + dx, current.y + dy)) {
+                current = Node{ current.x + dx, current.y + dy };
+                break;
+            }
+        }
+        path.push_back(current);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::pair<std::vector<Node>, CellBitset> WavefrontSearch::findPath(
+    const std::vector<std::vector<bool>>& walls,
+    const Node& start,
+    const Node& end
+) {
+    SearchResult result = search(Grid(walls), start, end);
+    return { std::move(result.path), std::move(result.explored) };
+}
+
+SearchResult WavefrontSearch::search(const Grid& grid, const Node& start, const Node& end, SearchControl* control) {
+    SearchResult result;
+    if (control && fixedBytes(grid) > control->memoryLimit()) {
+        result.status = SearchStatus::MemoryLimit;
+        return result;
+    }
+
+    WavefrontSearch wavefront(grid);
+    bool found = wavefront.run(start, end, control);
+
+    result.explored = wavefront.reached();
+    result.nodesExpanded = result.explored.count();
+    result.memory = wavefront.memoryUsage();
+    if (found) {
+        result.status = SearchStatus::Found;
+        result.path = wavefront.pathTo(end);
+        result.cost = gridPathCost(result.path);
+        result.memory.path = result.path.size() * sizeof(Node);
+        result.memory.peakBytes += result.memory.path;
+    }
+    else if (wavefront.stoppedAtMemoryLimit()) {
+        result.status = SearchStatus::MemoryLimit;
+    }
+    else if (control && control->isCancelled()) {
+        result.status = SearchStatus::Cancelled;
+    }
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+// WavefrontSearch.h
+#pragma once
+#include "Grid.h"
+#include "Node.h"
+#include "CellBitset.h"
+#include "BestFirstSearch.h"
+#include "SearchControl.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+enum class WavefrontMoves {
+    Four,   // Cardinal steps only
+    Eight   // Cardinal and diagonal steps, no corner cutting (as EightConnected)
+};
+
+// Breadth-first search that advances a whole layer of the frontier at a time
+// as bit-packed rows: the next layer is the frontier shifted one cell in each
+// direction, ANDed with the free-cell mask and with NOT visited, 64 cells per
+// word operation and no priority queue. Each step only touches the words next
+// to the current frontier.
+//
+// Every step costs one move, so distances are hop counts (equal to path cost
+// with Four moves, the fewest moves but not necessarily the cheapest 10/14
+// path with Eight). Each layer is kept as its non-empty words, which is enough
+// to answer distance queries and to walk a path back from any reached cell.
+class WavefrontSearch {
+public:
+    explicit WavefrontSearch(const Grid& grid, WavefrontMoves moves = WavefrontMoves::Eight);
+
+    // Expands layers from start until goal is reached, or until everything
+    // reachable has been reached. True if goal was reached.
+    bool run(const Node& start, const Node& goal, SearchControl* control = nullptr);
+    // Floods the whole component containing start.
+    void flood(const Node& start, SearchControl* control = nullptr);
+
+    // Results of the last run; layer 0 holds only the start.
+    size_t layerCount() const { return layerStart.empty() ? 0 : layerStart.size() - 1; }
+    int hopDistance(const Node& node) const;   // -1 when not reached
+    std::vector<int> hopDistances() const;     // Row-major, -1 when not reached
+    CellBitset reached() const;
+    // A fewest-moves path from the start, walked back through the layers;
+    // empty when node was not reached.
+    std::vector<Node> pathTo(const Node& node) const;
+    // Peak bytes of the last run, and whether it stopped at the control's memory limit.
+    const MemoryUsage& memoryUsage() const { return memory; }
+    bool stoppedAtMemoryLimit() const { return memoryExceeded; }
+
+    // Bytes the constructor allocates for grid: the four word planes and the
+    // two span arrays.
+    static size_t fixedBytes(const Grid& grid);
+
+    // Fewest-moves path with Eight moves, as a finder.
+    static std::pair<std::vector<Node>, CellBitset> findPath(
+        const std::vector<std::vector<bool>>& walls,
+        const Node& start,
+        const Node& end
+    );
+    static SearchResult search(const Grid& grid, const Node& start, const Node& end, SearchControl* control = nullptr);
+
+private:
+    struct LayerWord {
+        uint32_t word;  // Index into the padded word arrays
+        uint64_t bits;
+    };
+
+    int gridWidth;
+    int gridHeight;
+    size_t wordsPerRow;
+    size_t stride;                   // Words per stored row: wordsPerRow plus an empty word each side
+    WavefrontMoves moveSet;
+    // Bit x of row y lives in word (y + 1) * stride + x / 64 + 1. The empty
+    // words and rows around the grid stand in for its edges, so neighbouring
+    // words can be read without bounds checks.
+    std::vector<uint64_t> open;      // Free cells; bits past the width stay clear
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> frontier;  // Zero outside frontierSpans
+    std::vector<uint64_t> next;
+    // First and last non-empty word of each frontier row (first > last when
+    // the row is empty).
+    std::vector<std::pair<int, int>> frontierSpans;
+    std::vector<std::pair<int, int>> nextSpans;
+    std::vector<LayerWord> layerWords;
+    std::vector<size_t> layerStart;  // Layer k is layerWords[layerStart[k], layerStart[k + 1])
+    MemoryUsage memory;
+    bool memoryExceeded = false;
+
+    size_t wordIndex(int x, int y) const { return (y + 1) * stride + x / 64 + 1; }
+    Node cellOf(uint32_t word, int bit) const {
+        return Node{ static_cast<int>(word % stride - 1) * 64 + bit, static_cast<int>(word / stride) - 1 };
+    }
+    bool expand(const Node& start, const Node* goal, SearchControl* control);
+    uint64_t nextWord(size_t word) const;
+    bool isOpen(int x, int y) const;
+    bool inLayer(size_t layer, int x, int y) const;
+};
\ No newline at end of file
@@ -1,9 +1,21 @@
 // World.cpp
 #include "World.h"
 #include "PathfindingStats.h"
+#include "PathSmoothing.h"
 #include <iostream>
-
-World::World() : walls(Constants::GRID_HEIGHT, std::vector<bool>(Constants::GRID_WIDTH, false)) {
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+World::World()
+    : walls(Constants::GRID_HEIGHT, std::vector<bool>(Constants::GRID_WIDTH, false)),
+    exploredNodes(Constants::GRID_WIDTH, Constants::GRID_HEIGHT),
+    previousExplored(Constants::GRID_WIDTH, Constants::GRID_HEIGHT),
+    renderer(Constants::GRID_WIDTH, Constants::GRID_HEIGHT, Constants::CELL_SIZE),
+    components(Grid(walls)),
+    deadEnds(std::make_shared<DeadEndIndex>(Grid(walls))),
+    mapVersions(walls) {
 #ifdef _DEBUG
     std::cout << "World created with size: " << Constants::GRID_WIDTH << "x" << Constants::GRID_HEIGHT << std::endl;
 #endif
@@ -14,12 +26,40 @@ bool World::isValidCell(int x, int y) const {
 }
 
 void World::setWall(int x, int y, bool state) {
-    if (isValidCell(x, y)) {
-        walls[y][x] = state;
+    applyEdits(MapEditBatch().set(x, y, state));
+}
+
+std::optional<CellRect> World::applyEdits(const MapEditBatch& batch) {
+    std::vector<CellEdit> changed = batch.applyTo(walls);
+    if (changed.empty()) {
+        return std::nullopt;
+    }
+
+    // Derived state, once per batch and only for cells that changed
+    CellRect dirty{ 0, 0, 0, 0 };
+    for (const CellEdit& edit : changed) {
+        renderer.setWall(edit.x, edit.y, edit.wall);
+        dirty = dirty.united(CellRect{ edit.x, edit.y, edit.x + 1, edit.y + 1 });
+    }
+    components.setWalls(changed);
+    auto updatedDeadEnds = std::make_shared<DeadEndIndex>(*deadEnds);
+    updatedDeadEnds->setWalls(changed);
+    deadEnds = std::move(updatedDeadEnds);
+    mapVersions.publish(changed);
+    mapChanged();
 #ifdef _DEBUG
-        std::cout << "Wall at " << x << "," << y << " is now " << (walls[y][x] ? "true" : "false") << std::endl;
+    std::cout << "Applied " << batch.size() << " wall edits, " << changed.size() << " changed in "
+        << dirty.left << "," << dirty.top << " - " << dirty.right - 1 << "," << dirty.bottom - 1 << std::endl;
 #endif
-    }
+    return dirty;
+}
+
+// Drops everything computed for the previous map or endpoints. A background
+// search keeps running on the map version it started with.
+void World::mapChanged() {
+    anytimeSearch.reset();
+    stopReplay();
+    lastEvents.reset();
 }
 
 bool World::isWall(int x, int y) const {
@@ -32,8 +72,10 @@ bool World::isWall(int x, int y) const {
 void World::setStartPoint(int x, int y) {
     if (isValidCell(x, y)) {
         startPoint = std::make_pair(x, y);
-        currentPath.clear(); // Clear path when start point changes
-        exploredNodes.clear(); // Clear explored nodes
+        renderer.setStart(Node{ x, y });
+        cancelSearch();
+        mapChanged();
+        clearResult(); // Clear path and explored nodes when start point changes
 #ifdef _DEBUG
         std::cout << "Start point set to: " << x << "," << y << std::endl;
 #endif
@@ -43,212 +85,445 @@ void World::setStartPoint(int x, int y) {
 void World::setEndPoint(int x, int y) {
     if (isValidCell(x, y)) {
         endPoint = std::make_pair(x, y);
-        currentPath.clear(); // Clear path when end point changes
-        exploredNodes.clear(); // Clear explored nodes
+        renderer.setEnd(Node{ x, y });
+        cancelSearch();
+        mapChanged();
+        clearResult(); // Clear path and explored nodes when end point changes
 #ifdef _DEBUG
         std::cout << "End point set to: " << x << "," << y << std::endl;
 #endif
     }
 }
 
-void World::findPathDijkstra() {
-    if (!startPoint || !endPoint) {
-        return;
-    }
-
+// Answers queries between different components without searching. The
+// rejection is still timed and saved like any other query.
+bool World::rejectUnreachable(const std::string& algorithm) {
     Node start{ startPoint->first, startPoint->second };
     Node end{ endPoint->first, endPoint->second };
 
-    auto [path, explored] = PathfindingStats::timePathfinding(
-        "Dijkstra",
-        walls,
+    auto startTime = std::chrono::high_resolution_clock::now();
+    bool reachable = components.connected(start, end);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    if (reachable) {
+        return false;
+    }
+
+    clearResult();
+    PathfindingStats::saveStats(PathfindingResult{
+        algorithm,
+        0,
+        0,
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0,
+        PathfindingStats::generateMapId(walls),
+        Constants::GRID_WIDTH,
+        Constants::GRID_HEIGHT,
         start,
         end,
-        DijkstrasPathFinder::findPath
-    );
+        0
+    });
 
-    currentPath = path;
-    exploredNodes = explored;
+#ifdef _DEBUG
+    std::cout << algorithm << ": end point is not reachable from the start point" << std::endl;
+#endif
+    return true;
+}
 
+// Tie-breaking and dead-end pruning are part of the benchmarked
+// configuration, e.g. "A* (high-g)" or "Dijkstra (pruned)"
+std::string World::algorithmLabel(const std::string& algorithm) const {
+    std::string options;
+    if (algorithm == "A*" && tieBreakPolicy != TieBreakPolicy::None) {
+        options = tieBreakPolicyName(tieBreakPolicy);
+    }
+    if (algorithm == "Weighted A*" || algorithm == "Focal") {
+        std::stringstream epsilon;
+        epsilon << "eps=" << Constants::BOUNDED_SEARCH_EPSILON;
+        options = epsilon.str();
+    }
+    if (pruneDeadEnds && AsyncPathfinder::prunesDeadEnds(algorithm)) {
+        options += options.empty() ? "pruned" : ", pruned";
+    }
+    return options.empty() ? algorithm : algorithm + " (" + options + ")";
+}
+
+void World::compareExplored() const {
 #ifdef _DEBUG
-    std::cout << "Dijkstra's path found with " << currentPath.size() << " nodes, explored "
-        << exploredNodes.size() << " nodes" << std::endl;
+    std::cout << "Explored by both: " << (exploredNodes & previousExplored).count()
+        << ", only the current result: " << (exploredNodes - previousExplored).count()
+        << ", only the previous result: " << (previousExplored - exploredNodes).count() << std::endl;
 #endif
 }
 
-void World::findPathAStar() {
-    if (!startPoint || !endPoint) {
+void World::cycleTieBreakPolicy() {
+    tieBreakPolicy = static_cast<TieBreakPolicy>((static_cast<int>(tieBreakPolicy) + 1) % TIE_BREAK_POLICY_COUNT);
+#ifdef _DEBUG
+    std::cout << "A* tie-breaking: " << tieBreakPolicyName(tieBreakPolicy) << std::endl;
+#endif
+}
+
+void World::toggleDeadEndPruning() {
+    pruneDeadEnds = !pruneDeadEnds;
+#ifdef _DEBUG
+    std::cout << "Dead-end pruning " << (pruneDeadEnds ? "on" : "off") << ": " << deadEnds->prunedCount()
+        << " cells in " << deadEnds->regionCount() << " regions" << std::endl;
+#endif
+}
+
+void World::smoothCurrentPath() {
+    if (currentPath.size() <= 2) {
         return;
     }
 
-    Node start{ startPoint->first, startPoint->second };
-    Node end{ endPoint->first, endPoint->second };
+    std::vector<Node> cells = currentPath.toNodes();
+    WaypointPath waypoints = smoothPath(LineOfSight(Grid(walls)), cells);
+#ifdef _DEBUG
+    std::cout << "Smoothed " << cells.size() << " cells (" << toWaypoints(cells).size()
+        << " waypoints) to " << waypoints.size() << " waypoints, length "
+        << waypointPathLength(waypoints) << std::endl;
+#endif
+    showPath(CompactPath::fromCells(rasterizeWaypoints(waypoints)));
+}
 
-    auto [path, explored] = PathfindingStats::timePathfinding(
-        "A*",
-        walls,
-        start,
-        end,
-        AStarPathFinder::findPath
-    );
+void World::toggleTarget(int x, int y) {
+    if (!isValidCell(x, y)) {
+        return;
+    }
 
-    currentPath = path;
-    exploredNodes = explored;
+    Node cell{ x, y };
+    auto existing = std::find(targets.begin(), targets.end(), cell);
+    bool added = existing == targets.end();
+    if (added) {
+        targets.push_back(cell);
+    }
+    else {
+        targets.erase(existing);
+    }
+    renderer.setTarget(x, y, added);
+#ifdef _DEBUG
+    std::cout << "Target at " << x << "," << y << (added ? " added" : " removed") << ", "
+        << targets.size() << " targets" << std::endl;
+#endif
+}
 
+void World::findPathNearest(HWND hwnd) {
+    if (!startPoint || targets.empty()) {
+        return;
+    }
+
+    cancelSearch();
+    clearResult();
+    Node start{ startPoint->first, startPoint->second };
+
+    // Targets in other components can never be the nearest one
+    std::vector<Node> reachable;
+    for (const Node& target : targets) {
+        if (components.connected(start, target)) {
+            reachable.push_back(target);
+        }
+    }
+    if (reachable.empty()) {
 #ifdef _DEBUG
-    std::cout << "A* path found with " << currentPath.size() << " nodes, explored "
-        << exploredNodes.size() << " nodes" << std::endl;
+        std::cout << "Nearest target: no target is reachable from the start point" << std::endl;
 #endif
+        return;
+    }
+
+    PathQuery query;
+    query.algorithm = "Nearest target";
+    query.start = start;
+    query.end = reachable.front();  // Recorded with the stats; the search takes any of goals
+    query.recordEvents = recordEvents;
+    query.goals = std::move(reachable);
+    submitQuery(hwnd, query);
 }
 
-void World::findPathJPS() {
+void World::findPathAsync(HWND hwnd, const std::string& algorithm) {
     if (!startPoint || !endPoint) {
         return;
     }
 
-    Node start{ startPoint->first, startPoint->second };
-    Node end{ endPoint->first, endPoint->second };
+    cancelSearch();
+    clearResult();
+    if (rejectUnreachable(algorithmLabel(algorithm))) {
+        return;
+    }
 
-    auto [path, explored] = PathfindingStats::timePathfinding(
-        "JPS",
-        walls,
-        start,
-        end,
-        JPSPathFinder::findPath
+    PathQuery query{
+        algorithm,
+        Node{ startPoint->first, startPoint->second },
+        Node{ endPoint->first, endPoint->second },
+        tieBreakPolicy,
+        recordEvents,
+        pruneDeadEnds ? deadEnds : nullptr
+    };
+    if (algorithm == "Anytime A*") {
+        if (!anytimeSearch) {
+            anytimeSearch = std::make_shared<AnytimeSearch>(*mapVersions.current()->grid(), query.start, query.end,
+                std::chrono::milliseconds(Constants::ANYTIME_BUDGET_MS));
+        }
+        query.anytime = anytimeSearch;
+    }
+    submitQuery(hwnd, query);
+}
+
+void World::submitQuery(HWND hwnd, const PathQuery& query) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        generation = searchGeneration;
+    }
+
+    activeQuery = asyncPathfinder.submit(
+        mapVersions.current(),
+        query,
+        [this, hwnd, generation](std::vector<Node>&& batch) {
+            {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                if (generation != searchGeneration) return;
+                pendingExplored.insert(pendingExplored.end(), batch.begin(), batch.end());
+            }
+            // One message in flight at a time; the UI drains everything pending
+            if (!progressPosted.exchange(true)) {
+                PostMessage(hwnd, WM_SEARCH_PROGRESS, 0, 0);
+            }
+        },
+        [hwnd](uint64_t queryId, const QueryResult&) {
+            PostMessage(hwnd, WM_SEARCH_COMPLETE, static_cast<WPARAM>(queryId), 0);
+        }
     );
 
-    currentPath = path;
-    exploredNodes = explored;
+#ifdef _DEBUG
+    std::cout << algorithmLabel(query.algorithm) << " search started in the background" << std::endl;
+#endif
+}
+
+void World::cancelSearch() {
+    if (!activeQuery) {
+        return;
+    }
+
+    activeQuery->cancel();
+    activeQuery.reset();
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        searchGeneration++;
+        pendingExplored.clear();
+    }
 
 #ifdef _DEBUG
-    std::cout << "JPS path found with " << currentPath.size() << " nodes, explored "
-        << exploredNodes.size() << " nodes" << std::endl;
+    std::cout << "Background search cancelled" << std::endl;
 #endif
 }
 
-void World::findPathGreedy() {
-    if (!startPoint || !endPoint) {
+void World::onSearchProgress() {
+    progressPosted = false;
+    std::lock_guard<std::mutex> lock(progressMutex);
+    for (const Node& node : pendingExplored) {
+        if (exploredNodes.insert(node)) {
+            renderer.setExplored(node.x, node.y, true);
+        }
+    }
+    pendingExplored.clear();
+}
+
+void World::onSearchComplete(uint64_t queryId) {
+    // Completions of cancelled or superseded queries are ignored
+    if (!activeQuery || static_cast<WPARAM>(activeQuery->getId()) != static_cast<WPARAM>(queryId)) {
         return;
     }
 
-    Node start{ startPoint->first, startPoint->second };
-    Node end{ endPoint->first, endPoint->second };
+    QueryResult result;
+    std::optional<std::string> failure;
+    try {
+        result = activeQuery->takeResult();
+    }
+    catch (const std::exception& error) {
+        failure = error.what();
+    }
+    activeQuery.reset();
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        searchGeneration++;
+        pendingExplored.clear();
+    }
 
-    auto [path, explored] = PathfindingStats::timePathfinding(
-        "Greedy",
-        walls,
-        start,
-        end,
-        GreedyPathFinder::findPath
-    );
+    if (failure) {
+#ifdef _DEBUG
+        std::cout << "Background search failed: " << *failure << std::endl;
+#endif
+        return;
+    }
+    if (result.search.status == SearchStatus::Cancelled) {
+        return;
+    }
 
-    currentPath = path;
-    exploredNodes = explored;
+    if (result.events) {
+        lastEvents = std::move(result.events);
+        lastEvents->saveToFile(Constants::EVENT_LOG_FILE);
+#ifdef _DEBUG
+        std::cout << "Recorded " << lastEvents->eventCount() << " search events in "
+            << lastEvents->sizeBytes() << " bytes" << std::endl;
+#endif
+    }
+
+    showResult(CompactPath::fromCells(result.search.path), std::move(result.search.explored));
+
+    PathfindingStats::saveStats(PathfindingResult{
+        algorithmLabel(result.query.algorithm),
+        currentPath.size(),
+        exploredNodes.count(),
+        result.timeMs,
+        PathfindingStats::generateMapId(result.map->toWalls()),
+        result.map->width(),
+        result.map->height(),
+        result.query.start,
+        result.query.end,
+        result.search.memory.peakBytes
+    });
 
 #ifdef _DEBUG
-    std::cout << "Greedy path found with " << currentPath.size() << " nodes, explored "
-        << exploredNodes.size() << " nodes" << std::endl;
+    std::cout << algorithmLabel(result.query.algorithm) << " path found with " << currentPath.size()
+        << " nodes, explored " << exploredNodes.count() << " nodes in " << result.timeMs << " ms" << std::endl;
+    const std::string& algorithm = result.query.algorithm;
+    if (algorithm == "Weighted A*" || algorithm == "Focal" || algorithm == "Anytime A*") {
+        std::cout << "  within " << result.search.suboptimalityBound() << "x of optimal" << std::endl;
+    }
+    if (algorithm == "Nearest target" && !currentPath.empty()) {
+        std::cout << "  nearest of " << result.query.goals.size() << " reachable targets is "
+            << currentPath.back().x << "," << currentPath.back().y << std::endl;
+    }
+    if (result.map->version() != mapVersions.current()->version()) {
+        std::cout << "  (on map version " << result.map->version() << "; the map is now at version "
+            << mapVersions.current()->version() << ")" << std::endl;
+    }
 #endif
 }
 
-void World::render(HDC hdc) const {
-    // Fill background white
-    RECT clientRect;
-    GetClientRect(WindowFromDC(hdc), &clientRect);
-    FillRect(hdc, &clientRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+void World::toggleEventRecording() {
+    recordEvents = !recordEvents;
+#ifdef _DEBUG
+    std::cout << "Search event recording " << (recordEvents ? "on" : "off") << std::endl;
+#endif
+}
 
-    // Create brushes
-    HBRUSH blackBrush = CreateSolidBrush(RGB(0, 0, 0));
-    HBRUSH greenBrush = CreateSolidBrush(RGB(0, 255, 0));
-    HBRUSH redBrush = CreateSolidBrush(RGB(255, 0, 0));
-    HBRUSH blueBrush = CreateSolidBrush(RGB(0, 0, 255));
-    HBRUSH lightYellowBrush = CreateSolidBrush(RGB(255, 255, 200));
+// Replays the last recorded search from an empty overlay: expanded nodes and
+// JPS jump points appear in the order the search produced them, then the path.
+bool World::startReplay() {
+    if (!lastEvents) {
+        return false;
+    }
 
-    // Draw explored nodes
-    for (const Node& node : exploredNodes) {
-        if (!(startPoint && node.x == startPoint->first && node.y == startPoint->second) &&
-            !(endPoint && node.x == endPoint->first && node.y == endPoint->second)) {
-            RECT exploredRect = {
-                node.x * Constants::CELL_SIZE,
-                node.y * Constants::CELL_SIZE,
-                (node.x + 1) * Constants::CELL_SIZE,
-                (node.y + 1) * Constants::CELL_SIZE
-            };
-            FillRect(hdc, &exploredRect, lightYellowBrush);
-        }
+    CompactPath path = currentPath;
+    clearResult();
+    replayEvents = lastEvents->decode();
+    replayPath = std::move(path);
+    replayCursor = 0;
+    return true;
+}
+
+bool World::advanceReplay(size_t count) {
+    if (replayEvents.empty()) {
+        return false;
     }
 
-    // Draw walls
-    for (int y = 0; y < Constants::GRID_HEIGHT; y++) {
-        for (int x = 0; x < Constants::GRID_WIDTH; x++) {
-            if (walls[y][x]) {
-                RECT cellRect = {
-                    x * Constants::CELL_SIZE,
-                    y * Constants::CELL_SIZE,
-                    (x + 1) * Constants::CELL_SIZE,
-                    (y + 1) * Constants::CELL_SIZE
-                };
-                FillRect(hdc, &cellRect, blackBrush);
-            }
+    size_t end = (std::min)(replayEvents.size(), replayCursor + count);
+    for (; replayCursor < end; replayCursor++) {
+        const SearchEvent& event = replayEvents[replayCursor];
+        if (event.type != SearchEventType::Pop && event.type != SearchEventType::Jump) continue;
+        if (exploredNodes.insert(event.node)) {
+            renderer.setExplored(event.node.x, event.node.y, true);
         }
     }
 
-    // Draw path if it exists
-    for (const Node& node : currentPath) {
-        if (!(startPoint && node.x == startPoint->first && node.y == startPoint->second) &&
-            !(endPoint && node.x == endPoint->first && node.y == endPoint->second)) {
-            RECT pathRect = {
-                node.x * Constants::CELL_SIZE,
-                node.y * Constants::CELL_SIZE,
-                (node.x + 1) * Constants::CELL_SIZE,
-                (node.y + 1) * Constants::CELL_SIZE
-            };
-            FillRect(hdc, &pathRect, blueBrush);
-        }
+    if (replayCursor < replayEvents.size()) {
+        return true;
     }
+    CompactPath path = std::move(replayPath);
+    stopReplay();
+    showPath(std::move(path));
+    return false;
+}
+
+void World::stopReplay() {
+    replayEvents.clear();
+    replayPath = CompactPath();
+    replayCursor = 0;
+}
 
-    // Draw start point if exists
-    if (startPoint) {
-        RECT startRect = {
-            startPoint->first * Constants::CELL_SIZE,
-            startPoint->second * Constants::CELL_SIZE,
-            (startPoint->first + 1) * Constants::CELL_SIZE,
-            (startPoint->second + 1) * Constants::CELL_SIZE
-        };
-        FillRect(hdc, &startRect, greenBrush);
+void World::clearResult() {
+    showResult({}, {});
+}
+
+// Swaps in a new path and explored set, repainting only the cells that change.
+void World::showResult(CompactPath path, CellBitset explored) {
+    stopReplay();  // Any new result replaces a running replay
+    if (explored.width() == 0) {
+        explored = CellBitset(Constants::GRID_WIDTH, Constants::GRID_HEIGHT);  // Search gave up before recording
     }
 
-    // Draw end point if exists
-    if (endPoint) {
-        RECT endRect = {
-            endPoint->first * Constants::CELL_SIZE,
-            endPoint->second * Constants::CELL_SIZE,
-            (endPoint->first + 1) * Constants::CELL_SIZE,
-            (endPoint->second + 1) * Constants::CELL_SIZE
-        };
-        FillRect(hdc, &endRect, redBrush);
+    (exploredNodes - explored).forEach([this](const Node& node) {
+        renderer.setExplored(node.x, node.y, false);
+    });
+    (explored - exploredNodes).forEach([this](const Node& node) {
+        renderer.setExplored(node.x, node.y, true);
+    });
+    if (!exploredNodes.empty()) {
+        previousExplored = std::move(exploredNodes);
     }
+    exploredNodes = std::move(explored);
+    showPath(std::move(path));
+}
 
-    // Draw grid lines
-    HPEN gridPen = CreatePen(PS_SOLID, 1, RGB(200, 200, 200));
-    HPEN oldPen = (HPEN)SelectObject(hdc, gridPen);
+void World::showPath(CompactPath path) {
+    for (const Node& node : currentPath) {
+        renderer.setPath(node.x, node.y, false);
+    }
+    for (const Node& node : path) {
+        renderer.setPath(node.x, node.y, true);
+    }
+    currentPath = std::move(path);
+}
 
-    for (int x = 0; x <= Constants::GRID_WIDTH; x++) {
-        MoveToEx(hdc, x * Constants::CELL_SIZE, 0, nullptr);
-        LineTo(hdc, x * Constants::CELL_SIZE, Constants::GRID_HEIGHT * Constants::CELL_SIZE);
+std::optional<RECT> World::takeDirtyRect() {
+    std::optional<PixelRect> dirty = renderer.takeDirtyRect();
+    if (!dirty) {
+        return std::nullopt;
     }
+    return RECT{ dirty->left, dirty->top, dirty->right, dirty->bottom };
+}
 
-    for (int y = 0; y <= Constants::GRID_HEIGHT; y++) {
-        MoveToEx(hdc, 0, y * Constants::CELL_SIZE, nullptr);
-        LineTo(hdc, Constants::GRID_WIDTH * Constants::CELL_SIZE, y * Constants::CELL_SIZE);
+bool World::saveSnapshot(const std::string& path) const {
+    return renderer.pixels().writePNG(path);
+}
+
+// Copies the requested area of the back buffer to the window. Only the rows
+// in the area are described to GDI, so the source origin is the same whether
+// it treats the top-down DIB as starting at the top or the bottom.
+void World::render(HDC hdc, const RECT& area) const {
+    const PixelBuffer& frame = renderer.pixels();
+    int left = (std::max)(0, static_cast<int>(area.left));
+    int top = (std::max)(0, static_cast<int>(area.top));
+    int right = (std::min)(frame.width(), static_cast<int>(area.right));
+    int bottom = (std::min)(frame.height(), static_cast<int>(area.bottom));
+    if (left >= right || top >= bottom) {
+        return;
     }
 
-    // Cleanup
-    SelectObject(hdc, oldPen);
-    DeleteObject(gridPen);
-    DeleteObject(blackBrush);
-    DeleteObject(greenBrush);
-    DeleteObject(redBrush);
-    DeleteObject(blueBrush);
-    DeleteObject(lightYellowBrush);
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = frame.width();
+    info.bmiHeader.biHeight = -(bottom - top);  // Negative: top-down rows
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    StretchDIBits(
+        hdc,
+        left, top, right - left, bottom - top,
+        left, 0, right - left, bottom - top,
+        frame.row(top),
+        &info,
+        DIB_RGB_COLORS,
+        SRCCOPY
+    );
 }
\ No newline at end of file
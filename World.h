@@ -2,32 +2,110 @@
 #pragma once
 #include "framework.h"
 #include "Constants.h"
-#include "DijkstrasPathFinder.h"
 #include "AStarPathFinder.h"
-#include "JPSPathFinder.h"
-#include "GreedyPathFinder.h"
+#include "AsyncPathfinder.h"
+#include "GridRenderer.h"
+#include "CompactPath.h"
+#include "ComponentIndex.h"
+#include "DeadEndIndex.h"
+#include "MapEdit.h"
+#include "GridSnapshot.h"
 #include <vector>
 #include <optional>
-#include <set>
+#include <string>
+#include <mutex>
+#include <atomic>
+
+// Posted to the window by background searches (see World::findPathAsync)
+const UINT WM_SEARCH_PROGRESS = WM_APP + 1;
+const UINT WM_SEARCH_COMPLETE = WM_APP + 2;  // wParam: query id
 
 class World {
 public:
     World();
     void setWall(int x, int y, bool state);
+    // Applies a batch of wall edits as one change: the renderer, component
+    // index and resumable searches are updated once for the whole batch.
+    // Returns the cells that changed, or nothing if none did.
+    std::optional<CellRect> applyEdits(const MapEditBatch& batch);
     bool isWall(int x, int y) const;
     void setStartPoint(int x, int y);
     void setEndPoint(int x, int y);
-    void findPathDijkstra();
-    void findPathAStar();
-    void findPathJPS();
-    void findPathGreedy();
-    void render(HDC hdc) const;
+    // Candidate goals for findPathNearest; toggled on and off per cell.
+    void toggleTarget(int x, int y);
+    // Cheapest path from the start point to any of the targets, in one
+    // background search (see findPathAsync).
+    void findPathNearest(HWND hwnd);
+    void cycleTieBreakPolicy();
+    // Whether background A*, Dijkstra and Greedy searches skip dead ends.
+    void toggleDeadEndPruning();
+    // Debug output: how the current result's explored cells differ from the
+    // previous result's (e.g. run A*, then JPS, then compare).
+    void compareExplored() const;
+    // String-pulls the displayed path down to the waypoints it needs.
+    void smoothCurrentPath();
+
+    // Runs the named algorithm on a worker thread against the current map
+    // version. Explored nodes stream in through WM_SEARCH_PROGRESS and the
+    // result arrives with WM_SEARCH_COMPLETE. Moving the endpoints cancels the
+    // search; wall edits do not, since the search reads its own snapshot.
+    // Each "Anytime A*" query spends one time slice improving the same ARA*
+    // search, so repeated presses converge on the optimal path.
+    void findPathAsync(HWND hwnd, const std::string& algorithm);
+    void cancelSearch();
+    void onSearchProgress();
+    void onSearchComplete(uint64_t queryId);
+    bool isSearching() const { return activeQuery.has_value(); }
+
+    // When enabled, background searches record a SearchEventLog that is saved
+    // to Constants::EVENT_LOG_FILE and can be replayed step by step.
+    void toggleEventRecording();
+    bool startReplay();
+    // Applies the next count events; false once the replay is over.
+    bool advanceReplay(size_t count);
+
+    // Blits the given client area from the off-screen pixel buffer.
+    void render(HDC hdc, const RECT& area) const;
+    // Client area changed since the last call; invalidate only this.
+    std::optional<RECT> takeDirtyRect();
+    bool saveSnapshot(const std::string& path) const;
 
 private:
     std::vector<std::vector<bool>> walls;
     std::optional<std::pair<int, int>> startPoint;
     std::optional<std::pair<int, int>> endPoint;
-    std::vector<Node> currentPath;
-    std::set<Node> exploredNodes;
+    std::vector<Node> targets;
+    CompactPath currentPath;
+    CellBitset exploredNodes;
+    CellBitset previousExplored;         // Explored set of the result before the current one
+    TieBreakPolicy tieBreakPolicy = TieBreakPolicy::None;
+    GridRenderer renderer;
+    ComponentIndex components;           // Kept in step with walls by setWall
+    // Immutable once published, like the map versions: every edit batch
+    // updates a copy, so background searches keep the index they started with
+    std::shared_ptr<const DeadEndIndex> deadEnds;
+    bool pruneDeadEnds = true;
+    VersionedGrid mapVersions;           // Published copy of walls for background searches
+    std::shared_ptr<AnytimeSearch> anytimeSearch;  // Resumed until the map or endpoints change
+    std::optional<QueryHandle> activeQuery;
+    std::mutex progressMutex;
+    std::vector<Node> pendingExplored;   // Guarded by progressMutex
+    uint64_t searchGeneration = 0;       // Guarded by progressMutex; drops progress from stale searches
+    std::atomic<bool> progressPosted{ false };
+    bool recordEvents = false;
+    std::shared_ptr<SearchEventLog> lastEvents;  // From the last completed search on the current map
+    std::vector<SearchEvent> replayEvents;       // Empty when no replay is running
+    size_t replayCursor = 0;
+    CompactPath replayPath;
+    AsyncPathfinder asyncPathfinder;     // Last, so its workers are joined before the members above go away
+
     bool isValidCell(int x, int y) const;
+    bool rejectUnreachable(const std::string& algorithm);
+    void mapChanged();
+    void stopReplay();
+    std::string algorithmLabel(const std::string& algorithm) const;
+    void showResult(CompactPath path, CellBitset explored);
+    void showPath(CompactPath path);
+    void clearResult();
+    void submitQuery(HWND hwnd, const PathQuery& query);
 };
\ No newline at end of file
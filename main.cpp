@@ -1,13 +1,17 @@
 // main.cpp
 #include "framework.h"
 #include "World.h"
+#include "PathfindingStats.h"
 #include "Constants.h"
 #include <iostream>
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+void invalidateDirty(HWND hwnd);
 std::unique_ptr<World> world;
 bool isLeftMouseDown = false;
 std::optional<bool> currentDrawMode;  // true for adding walls, false for removing
+Node lastDrawCell{ 0, 0 };              // Cell of the previous mouse event while drawing
+const UINT_PTR REPLAY_TIMER_ID = 1;
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
 #ifdef _DEBUG
@@ -66,6 +70,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
     case WM_DESTROY:
+        PathfindingStats::flushStats();
         PostQuitMessage(0);
         return 0;
 
@@ -75,28 +80,99 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     case WM_PAINT: {
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
-        world->render(hdc);
+        world->render(hdc, ps.rcPaint);
         EndPaint(hwnd, &ps);
         return 0;
     }
 
+    case WM_SEARCH_PROGRESS:
+        world->onSearchProgress();
+        invalidateDirty(hwnd);
+        return 0;
+
+    case WM_SEARCH_COMPLETE:
+        world->onSearchComplete(static_cast<uint64_t>(wParam));
+        invalidateDirty(hwnd);
+        return 0;
+
+    case WM_TIMER:
+        if (wParam == REPLAY_TIMER_ID) {
+            if (!world->advanceReplay(Constants::REPLAY_EVENTS_PER_TICK)) {
+                KillTimer(hwnd, REPLAY_TIMER_ID);
+            }
+            invalidateDirty(hwnd);
+        }
+        return 0;
+
     case WM_KEYDOWN: {
         switch (wParam) {
         case 'A':
-            world->findPathAStar();
-            InvalidateRect(hwnd, nullptr, FALSE);
+            world->findPathAsync(hwnd, "A*");
+            invalidateDirty(hwnd);
             break;
         case 'D':
-            world->findPathDijkstra();
-            InvalidateRect(hwnd, nullptr, FALSE);
+            world->findPathAsync(hwnd, "Dijkstra");
+            invalidateDirty(hwnd);
             break;
         case 'J':
-            world->findPathJPS();
-            InvalidateRect(hwnd, nullptr, FALSE);
+            world->findPathAsync(hwnd, "JPS");
+            invalidateDirty(hwnd);
             break;
         case 'G':
-			world->findPathGreedy();
-            InvalidateRect(hwnd, nullptr, FALSE);
+            world->findPathAsync(hwnd, "Greedy");
+            invalidateDirty(hwnd);
+            break;
+        case 'H':
+            world->findPathAsync(hwnd, "Theta*");
+            invalidateDirty(hwnd);
+            break;
+        case 'B':
+            world->findPathAsync(hwnd, "BFS");
+            invalidateDirty(hwnd);
+            break;
+        case 'S':
+            world->smoothCurrentPath();
+            invalidateDirty(hwnd);
+            break;
+        case VK_ESCAPE:
+            world->cancelSearch();
+            break;
+        case 'W':
+            world->findPathAsync(hwnd, "Weighted A*");
+            invalidateDirty(hwnd);
+            break;
+        case 'F':
+            world->findPathAsync(hwnd, "Focal");
+            invalidateDirty(hwnd);
+            break;
+        case 'N':
+            world->findPathNearest(hwnd);
+            invalidateDirty(hwnd);
+            break;
+        case 'I':
+            world->findPathAsync(hwnd, "Anytime A*");
+            invalidateDirty(hwnd);
+            break;
+        case 'P':
+            world->saveSnapshot("snapshot.png");
+            break;
+        case 'T':
+            world->cycleTieBreakPolicy();
+            break;
+        case 'E':
+            world->toggleDeadEndPruning();
+            break;
+        case 'C':
+            world->compareExplored();
+            break;
+        case 'L':
+            world->toggleEventRecording();
+            break;
+        case 'R':
+            if (world->startReplay()) {
+                SetTimer(hwnd, REPLAY_TIMER_ID, Constants::REPLAY_TICK_MS, nullptr);
+                invalidateDirty(hwnd);
+            }
             break;
         }
         return 0;
@@ -112,10 +188,11 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             // Set the draw mode based on the initial cell state
             currentDrawMode = !world->isWall(gridX, gridY);
             world->setWall(gridX, gridY, *currentDrawMode);
+            lastDrawCell = Node{ gridX, gridY };
 #ifdef _DEBUG
             std::cout << "Adding wall at: " << gridX << ", " << gridY << std::endl;
 #endif
-            InvalidateRect(hwnd, nullptr, FALSE);
+            invalidateDirty(hwnd);
         }
         return 0;
     }
@@ -132,9 +209,12 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             int gridX = pt.x / Constants::CELL_SIZE;
             int gridY = pt.y / Constants::CELL_SIZE;
             if (gridX >= 0 && gridX < Constants::GRID_WIDTH &&
-                gridY >= 0 && gridY < Constants::GRID_HEIGHT) {
-                world->setWall(gridX, gridY, *currentDrawMode);
-                InvalidateRect(hwnd, nullptr, FALSE);
+                gridY >= 0 && gridY < Constants::GRID_HEIGHT &&
+                !(lastDrawCell == Node{ gridX, gridY })) {
+                // Fill in the cells skipped between move events as one edit
+                world->applyEdits(MapEditBatch().line(lastDrawCell.x, lastDrawCell.y, gridX, gridY, *currentDrawMode));
+                lastDrawCell = Node{ gridX, gridY };
+                invalidateDirty(hwnd);
             }
         }
         return 0;
@@ -146,7 +226,13 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         int gridY = pt.y / Constants::CELL_SIZE;
         if (gridX >= 0 && gridX < Constants::GRID_WIDTH &&
             gridY >= 0 && gridY < Constants::GRID_HEIGHT) {
-            if (GetKeyState(VK_CONTROL) & 0x8000) {
+            if (GetKeyState(VK_SHIFT) & 0x8000) {
+#ifdef _DEBUG
+                std::cout << "Toggling target at: " << gridX << ", " << gridY << std::endl;
+#endif
+                world->toggleTarget(gridX, gridY);
+            }
+            else if (GetKeyState(VK_CONTROL) & 0x8000) {
 #ifdef _DEBUG
                 std::cout << "Setting end point at: " << gridX << ", " << gridY << std::endl;
 #endif
@@ -158,10 +244,17 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 #endif
                 world->setStartPoint(gridX, gridY);
             }
-            InvalidateRect(hwnd, nullptr, FALSE);
+            invalidateDirty(hwnd);
         }
         return 0;
     }
     }
     return DefWindowProc(hwnd, uMsg, wParam, lParam);
+}
+
+// Invalidates only the cells whose pixels changed since the last paint.
+void invalidateDirty(HWND hwnd) {
+    if (std::optional<RECT> dirty = world->takeDirtyRect()) {
+        InvalidateRect(hwnd, &*dirty, FALSE);
+    }
 }
\ No newline at end of file